@@ -0,0 +1,55 @@
+// File: Black76Batch.cpp
+// Author(s): Jingyi Guo
+
+#include <cstddef>
+#include <cmath>
+using namespace std;
+#include "Black76Batch.h"
+
+void NormCDFBatch(const double* x, double* out, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+		out[i] = FastNormCDF(x[i]);
+}
+
+// d1 and d2 of option i, written so that each loop below stays one
+// straight run of arithmetic
+static inline void D1D2(double f, double k, double t, double sigma, double& d1, double& d2)
+{
+	double sd = sigma * sqrt(t);
+	d1 = FastLog(f / k) / sd + 0.5 * sd;
+	d2 = d1 - sd;
+}
+
+void Black76CallBatch(const double* f, const double* k, const double* r,
+	const double* t, const double* sigma, double* out, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		double d1, d2;
+		D1D2(f[i], k[i], t[i], sigma[i], d1, d2);
+		out[i] = FastExp(-r[i] * t[i]) * (f[i] * FastNormCDF(d1) - k[i] * FastNormCDF(d2));
+	}
+}
+
+void Black76PutBatch(const double* f, const double* k, const double* r,
+	const double* t, const double* sigma, double* out, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		double d1, d2;
+		D1D2(f[i], k[i], t[i], sigma[i], d1, d2);
+		out[i] = FastExp(-r[i] * t[i]) * (k[i] * FastNormCDF(-d2) - f[i] * FastNormCDF(-d1));
+	}
+}
+
+void Black76VegaBatch(const double* f, const double* k, const double* r,
+	const double* t, const double* sigma, double* out, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		double d1, d2;
+		D1D2(f[i], k[i], t[i], sigma[i], d1, d2);
+		out[i] = FastExp(-r[i] * t[i] - 0.5 * d1 * d1) * f[i] * sqrt(t[i]) * 0.3989422804014327;
+	}
+}
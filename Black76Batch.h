@@ -0,0 +1,161 @@
+// File: Black76Batch.h
+// Author(s): Jingyi Guo
+//
+// Branch-free exp, log and NormCDF, and Black-76 kernels that apply
+// them to whole arrays.  The scalar functions are plain straight-line
+// code (selects, no calls), so the loops in Black76Batch.cpp
+// vectorise: build it with -O3 -fno-math-errno and -march=native (or
+// at least -mavx2 -mfma) to get the SIMD versions; without
+// -fno-math-errno the sqrt calls keep the loops scalar.  Error bounds
+// were measured against long double on dense grids over the stated
+// ranges; black76bench (Black76Bench.cpp) checks the ones below for
+// NormCDF and the Black-76 kernels, and times them.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+using namespace std;
+#ifndef _BLACK76_BATCH_
+#define _BLACK76_BATCH_
+
+// c ? a : b done on the bits; gcc will not if-convert a plain ?: on
+// doubles in a loop that also does integer work on them, short of
+// AVX-512
+inline double Select(bool c, double a, double b)
+{
+    int64_t mask = -(int64_t)c, ia, ib;
+    memcpy(&ia, &a, sizeof(ia));
+    memcpy(&ib, &b, sizeof(ib));
+    ia = (ia & mask) | (ib & ~mask);
+    memcpy(&a, &ia, sizeof(a));
+    return a;
+}
+
+// exp(x): relative error below 5e-16 for -708 <= x <= 709;
+// x is clamped to that range, so the result never overflows or
+// turns subnormal
+inline double FastExp(double x)
+{
+    x = Select(x < -708.0, -708.0, Select(x > 709.0, 709.0, x));
+    // x = n ln2 + r, |r| <= ln2/2; adding 1.5*2^52 rounds to an
+    // integer, which then sits in the low bits of the sum
+    const double shifter = 6755399441055744.0;
+    double shifted = x * 1.4426950408889634 + shifter;
+    double n = shifted - shifter;
+    double r = x - n * 6.93147180369123816490e-01;   // ln2, high part
+    r = r - n * 1.90821492927058770002e-10;          // ln2, low part
+    // Taylor series to r^12; the first omitted term is below 2e-16
+    double p = 1.0 / 479001600;
+    p = p * r + 1.0 / 39916800;
+    p = p * r + 1.0 / 3628800;
+    p = p * r + 1.0 / 362880;
+    p = p * r + 1.0 / 40320;
+    p = p * r + 1.0 / 5040;
+    p = p * r + 1.0 / 720;
+    p = p * r + 1.0 / 120;
+    p = p * r + 1.0 / 24;
+    p = p * r + 1.0 / 6;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+    // 2^n straight into the exponent bits (integer ops only, which
+    // vectorise where a double -> int64 conversion would not)
+    int64_t nbits, sbits;
+    memcpy(&nbits, &shifted, sizeof(nbits));
+    memcpy(&sbits, &shifter, sizeof(sbits));
+    int64_t bits = (nbits - sbits + 1023) << 52;
+    double scale;
+    memcpy(&scale, &bits, sizeof(scale));
+    return p * scale;
+}
+
+// log(x) for normal positive x: relative error below 5e-16,
+// absolute error below 2e-16 near x = 1; 0, negatives and
+// subnormals are not checked
+inline double FastLog(double x)
+{
+    int64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    // x = 2^e m with m in [sqrt(1/2), sqrt(2))
+    int64_t e = ((bits >> 52) & 0x7ff) - 1023;
+    int64_t mbits = (bits & 0x000fffffffffffffLL) | 0x3ff0000000000000LL;
+    double m;
+    memcpy(&m, &mbits, sizeof(m));
+    bool big = m > 1.4142135623730951;
+    m = Select(big, m * 0.5, m);
+    e += big;
+    // e as a double, the FastExp trick in reverse
+    const double shifter = 6755399441055744.0;
+    int64_t sbits;
+    memcpy(&sbits, &shifter, sizeof(sbits));
+    sbits += e;
+    double de;
+    memcpy(&de, &sbits, sizeof(de));
+    de -= shifter;
+    // log m = 2 atanh(s), s = (m-1)/(m+1), |s| <= 0.1716
+    double s = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    double p = 1.0 / 19;
+    p = p * s2 + 1.0 / 17;
+    p = p * s2 + 1.0 / 15;
+    p = p * s2 + 1.0 / 13;
+    p = p * s2 + 1.0 / 11;
+    p = p * s2 + 1.0 / 9;
+    p = p * s2 + 1.0 / 7;
+    p = p * s2 + 1.0 / 5;
+    p = p * s2 + 1.0 / 3;
+    p = p * s2 + 1.0;
+    return de * 6.93147180369123816490e-01 + (2.0 * s * p + de * 1.90821492927058770002e-10);
+}
+
+// NormCDF(x) by Hart's rational approximation (West, 2005): absolute
+// error below 3e-16 everywhere; relative error below 2e-14 for
+// x > -3, growing to 1e-8 in the far left tail
+inline double FastNormCDF(double x)
+{
+    double a = fabs(x);
+    double e = FastExp(-0.5 * a * a);
+    double num = 3.52624965998911e-02 * a + 0.700383064443688;
+    num = num * a + 6.37396220353165;
+    num = num * a + 33.912866078383;
+    num = num * a + 112.079291497871;
+    num = num * a + 221.213596169931;
+    num = num * a + 220.206867912376;
+    double den = 8.83883476483184e-02 * a + 1.75566716318264;
+    den = den * a + 16.064177579207;
+    den = den * a + 86.7807322029461;
+    den = den * a + 296.564248779674;
+    den = den * a + 637.333633378831;
+    den = den * a + 793.826512519948;
+    den = den * a + 440.413735824752;
+    double inner = e * num / den;
+    // continued fraction for the tail
+    double cf = a + 0.65;
+    cf = a + 4.0 / cf;
+    cf = a + 3.0 / cf;
+    cf = a + 2.0 / cf;
+    cf = a + 1.0 / cf;
+    double outer = e / cf * 0.3989422804014327;
+    double tail = Select(a < 7.07106781186547, inner, Select(a > 37.0, 0.0, outer));
+    return Select(x > 0, 1.0 - tail, tail);
+}
+
+// out[i] = NormCDF(x[i])
+void NormCDFBatch(const double* x, double* out, size_t n);
+
+// Black-76 prices and vega of n options, one array per input.
+// t and sigma must be positive.  Absolute error of a price is below
+// 1e-15 max(f, k).  Relative error of a call is below 5e-13 for
+// |d2| < 3 and 1e-9 for |d2| < 5, of a put below 1e-12 and 2e-9;
+// beyond that the price is a difference of two tiny terms.  Vega's
+// relative error is below 5e-14 for |d1| < 3 and 1e-13 for |d1| < 5,
+// and grows about as d1^2 beyond, to 1e-12 by |d1| = 37: an error in
+// d1 is magnified by exp(-d1^2/2), in libm's double as much as here.
+void Black76CallBatch(const double* f, const double* k, const double* r,
+                      const double* t, const double* sigma, double* out, size_t n);
+void Black76PutBatch(const double* f, const double* k, const double* r,
+                     const double* t, const double* sigma, double* out, size_t n);
+void Black76VegaBatch(const double* f, const double* k, const double* r,
+                      const double* t, const double* sigma, double* out, size_t n);
+#endif
@@ -0,0 +1,251 @@
+// File: Black76Bench.cpp
+// Author(s): Jingyi Guo
+//
+// Usage:  black76bench [options [repetitions [seed]]]
+//   Draws options (default 1048576) with forwards from 10 to 200,
+//   strikes from 0.2 to 4.5 times the forward, 0.01 to 2 years to
+//   expiry, vols from 0.05 to 1 and rates from 0 to 0.08, and as many
+//   points from -38 to 38 for NormCDF.  Times the batch kernels of
+//   Black76Batch.cpp against loops over the OptionMath.h formulas,
+//   which call libm, and prints one CSV line per kernel, the best of
+//   the repetitions (default 5).
+//   Then it works every value out again in long double, and prints,
+//   for each bound stated in Black76Batch.h, the largest error of the
+//   batch kernel and of the libm loop over that bound's range, and the
+//   input it was found at.  It fails if a batch kernel is outside its
+//   bound.
+//
+// Build:  g++ -std=c++17 -O3 -fno-math-errno -march=native Black76Bench.cpp Black76Batch.cpp -o black76bench
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+using namespace std;
+#include "Black76Batch.h"
+#include "OptionMath.h"
+
+// xorshift64*: the same options from the same seed
+struct Random {
+	unsigned long long x;
+	Random(unsigned long long seed) : x(seed * 0x9E3779B97F4A7C15ULL + 1) { }
+	double uniform(double lo, double hi)
+	{
+		x ^= x >> 12;
+		x ^= x << 25;
+		x ^= x >> 27;
+		return lo + (hi - lo) * ((x * 0x2545F4914F6CDD1DULL) >> 11) * (1.0 / 9007199254740992.0);
+	}
+};
+
+// one array per input, as the kernels take them
+struct Options {
+	vector<double> f, k, r, t, sigma;
+
+	Options(size_t n, unsigned long long seed) : f(n), k(n), r(n), t(n), sigma(n)
+	{
+		Random rng(seed);
+		for (size_t i = 0; i < n; ++i)
+		{
+			f[i] = rng.uniform(10, 200);
+			k[i] = f[i] * exp(rng.uniform(log(0.2), log(4.5)));
+			r[i] = rng.uniform(0, 0.08);
+			t[i] = rng.uniform(0.01, 2);
+			sigma[i] = rng.uniform(0.05, 1);
+		}
+	}
+	size_t size() const { return f.size(); }
+};
+
+/* ---------------- timing ----------------- */
+
+typedef void (*BatchKernel)(const double*, const double*, const double*, const double*, const double*, double*, size_t);
+typedef double (*ScalarFormula)(const double&, const double&, const double&, const double&, const double&);
+
+void ScalarLoop(ScalarFormula formula, const Options& o, double* out)
+{
+	for (size_t i = 0; i < o.size(); ++i)
+		out[i] = formula(o.f[i], o.k[i], o.r[i], o.t[i], o.sigma[i]);
+}
+
+// ns per option, the best of reps runs
+template <class Run>
+double Time(Run run, size_t n, int reps)
+{
+	double best = 1e300;
+	for (int r = 0; r < reps; ++r)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		run();
+		double ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+		if (ns < best)
+			best = ns;
+	}
+	return best / n;
+}
+
+/* ---------------- the reference ----------------- */
+
+long double NormCDFRef(long double x)
+{
+	return 0.5L * erfcl(-x / sqrtl(2.0L));
+}
+
+// the price or vega of option i in long double, and the quantity its
+// bounds are stated over: |d2| for a price, |d1| for vega.  A put
+// comes from its own tails, not from a call and parity, so a deep out
+// of the money one is not a difference of large numbers.
+long double Reference(int kernel, const Options& o, size_t i, double& key)
+{
+	long double sd = (long double)o.sigma[i] * sqrtl((long double)o.t[i]);
+	long double d1 = logl((long double)o.f[i] / o.k[i]) / sd + 0.5L * sd;
+	long double d2 = d1 - sd;
+	long double df = expl(-(long double)o.r[i] * o.t[i]);
+	key = (double)fabsl(kernel == 2 ? d1 : d2);
+	if (kernel == 0)
+		return df * (o.f[i] * NormCDFRef(d1) - o.k[i] * NormCDFRef(d2));
+	if (kernel == 1)
+		return df * (o.k[i] * NormCDFRef(-d2) - o.f[i] * NormCDFRef(-d1));
+	return df * o.f[i] * sqrtl((long double)o.t[i]) * expl(-0.5L * d1 * d1)
+		/ sqrtl(2.0L * 3.14159265358979323846264338327950288L);
+}
+
+/* ---------------- errors ----------------- */
+
+// the largest error over the values in one range, relative to the
+// value itself, or to a scale for an absolute bound
+struct WorstCase {
+	double error;
+	size_t at;
+	WorstCase() : error(0), at(0) { }
+	void add(double got, long double want, long double scale, size_t i)
+	{
+		double e = (double)fabsl((got - want) / scale);
+		if (e > error || e != e)
+		{
+			error = e;
+			at = i;
+		}
+	}
+};
+
+// a range a bound is stated over in Black76Batch.h: the values whose
+// key is below below
+struct Range {
+	int kernel;
+	const char* name;
+	double below;
+	bool absolute;             // error over max(f, k), not the value
+	double bound;              // as stated in Black76Batch.h
+};
+
+int main(int argc, char* argv[])
+{
+	size_t n = argc > 1 ? strtoul(argv[1], 0, 10) : 1 << 20;
+	int reps = argc > 2 ? atoi(argv[2]) : 5;
+	unsigned long long seed = argc > 3 ? strtoull(argv[3], 0, 10) : 20160826;
+	if (n == 0 || reps <= 0)
+	{
+		cerr << "usage: " << argv[0] << " [options [repetitions [seed]]]\n";
+		return 1;
+	}
+	Options o(n, seed);
+	// NormCDF on its own, over all of its range
+	vector<double> x(n);
+	Random rng(seed + 1);
+	for (size_t i = 0; i < n; ++i)
+		x[i] = rng.uniform(-38, 38);
+
+	const char* names[] = { "call", "put", "vega", "normcdf" };
+	BatchKernel batch[] = { Black76CallBatch, Black76PutBatch, Black76VegaBatch };
+	ScalarFormula scalar[] = { Black76CallPrice<double>, Black76PutPrice<double>, Black76Vega<double> };
+	vector<double> fast[4], libm[4];
+
+	cout << "kernel,values,batch_ns_per_value,libm_ns_per_value\n";
+	for (int c = 0; c < 4; ++c)
+	{
+		fast[c].resize(n);
+		libm[c].resize(n);
+		double* out = &fast[c][0];
+		double* ref = &libm[c][0];
+		double batchNs, libmNs;
+		if (c < 3)
+		{
+			batchNs = Time([&]() { batch[c](&o.f[0], &o.k[0], &o.r[0], &o.t[0], &o.sigma[0], out, n); }, n, reps);
+			libmNs = Time([&]() { ScalarLoop(scalar[c], o, ref); }, n, reps);
+		}
+		else
+		{
+			batchNs = Time([&]() { NormCDFBatch(&x[0], out, n); }, n, reps);
+			libmNs = Time([&]() { for (size_t i = 0; i < n; ++i) ref[i] = NormCDF(x[i]); }, n, reps);
+		}
+		cout << names[c] << "," << n << "," << batchNs << "," << libmNs << "\n";
+	}
+
+	// the reference, and each value's key: |d2|, |d1|, or -x for NormCDF
+	vector<long double> want[4];
+	vector<double> key[4];
+	for (int c = 0; c < 4; ++c)
+	{
+		want[c].resize(n);
+		key[c].resize(n);
+		for (size_t i = 0; i < n; ++i)
+			if (c < 3)
+				want[c][i] = Reference(c, o, i, key[c][i]);
+			else
+			{
+				want[c][i] = NormCDFRef(x[i]);
+				key[c][i] = -x[i];
+			}
+	}
+
+	const double all = 1e300;
+	const Range ranges[] = {
+		{ 0, "|d2|<3", 3, false, 5e-13 },
+		{ 0, "|d2|<5", 5, false, 1e-9 },
+		{ 0, "all", all, true, 1e-15 },
+		{ 1, "|d2|<3", 3, false, 1e-12 },
+		{ 1, "|d2|<5", 5, false, 2e-9 },
+		{ 1, "all", all, true, 1e-15 },
+		{ 2, "|d1|<3", 3, false, 5e-14 },
+		{ 2, "|d1|<5", 5, false, 1e-13 },
+		{ 2, "|d1|<37", 37, false, 1e-12 },
+		{ 3, "x>-3", 3, false, 2e-14 },
+		{ 3, "all", all, true, 3e-16 },
+	};
+
+	bool within = true;
+	cout << "\nkernel,range,values,batch_max_error,bound,libm_max_error,worst_f,worst_k,worst_t,worst_sigma,worst_x\n";
+	for (size_t g = 0; g < sizeof(ranges) / sizeof(ranges[0]); ++g)
+	{
+		const Range& range = ranges[g];
+		int c = range.kernel;
+		WorstCase batchWorst, libmWorst;
+		size_t count = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (!(key[c][i] < range.below))
+				continue;
+			long double scale = !range.absolute ? want[c][i] : c < 3 ? max(o.f[i], o.k[i]) : 1;
+			batchWorst.add(fast[c][i], want[c][i], scale, i);
+			libmWorst.add(libm[c][i], want[c][i], scale, i);
+			++count;
+		}
+		size_t w = batchWorst.at;
+		cout << names[c] << "," << range.name << (range.absolute ? " abs" : "") << "," << count << ","
+			<< batchWorst.error << "," << range.bound << "," << libmWorst.error << ",";
+		if (c < 3)
+			cout << o.f[w] << "," << o.k[w] << "," << o.t[w] << "," << o.sigma[w] << ",\n";
+		else
+			cout << ",,,," << x[w] << "\n";
+		if (!(batchWorst.error <= range.bound))
+		{
+			cerr << names[c] << " batch error " << batchWorst.error << " is outside the bound "
+				<< range.bound << " for " << range.name << "\n";
+			within = false;
+		}
+	}
+	return within ? 0 : 1;
+}
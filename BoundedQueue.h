@@ -0,0 +1,67 @@
+// File: BoundedQueue.h
+// Author(s): Jingyi Guo
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+using namespace std;
+#ifndef _BOUNDED_QUEUE_
+#define _BOUNDED_QUEUE_
+
+// A FIFO between threads that holds at most capacity items: push()
+// waits while it is full, pop() while it is empty, so a fast stage
+// can never run more than capacity items ahead of a slow one.
+// close() says no more items are coming; pop() then drains what is
+// left and returns false.
+template <class T>
+class BoundedQueue {
+public:
+    BoundedQueue(size_t capacity) : d_capacity(capacity < 1 ? 1 : capacity), d_closed(false) { }
+
+    void push(const T& item)
+    {
+        {
+            unique_lock<mutex> guard(d_lock);
+            while (d_items.size() == d_capacity)
+                d_notFull.wait(guard);
+            d_items.push_back(item);
+        }
+        d_notEmpty.notify_one();
+    }
+
+    bool pop(T& item)
+    {
+        {
+            unique_lock<mutex> guard(d_lock);
+            while (d_items.empty() && !d_closed)
+                d_notEmpty.wait(guard);
+            if (d_items.empty())
+                return false;
+            item = d_items.front();
+            d_items.pop_front();
+        }
+        d_notFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            lock_guard<mutex> guard(d_lock);
+            d_closed = true;
+        }
+        d_notEmpty.notify_all();
+    }
+private:
+    BoundedQueue(const BoundedQueue&);
+    BoundedQueue& operator=(const BoundedQueue&);
+
+    size_t d_capacity;
+    bool d_closed;
+    deque<T> d_items;
+    mutex d_lock;
+    condition_variable d_notEmpty;
+    condition_variable d_notFull;
+};
+#endif
@@ -0,0 +1,168 @@
+// File: ContractStore.cpp
+// Author(s): Jingyi Guo
+
+#include <algorithm>
+#include <vector>
+using namespace std;
+#include "ContractStore.h"
+
+// product, month and type packed into one integer, so that the
+// indexes are plain sorted arrays of keys
+unsigned long long ContractStore::make_key(const char* product, int yyyymm, char type)
+{
+	return ((unsigned long long)(unsigned char)product[0] << 48)
+		| ((unsigned long long)(unsigned char)product[1] << 40)
+		| ((unsigned long long)(unsigned)yyyymm << 8)
+		| (unsigned char)type;
+}
+
+ContractStore::ContractStore()
+{ }
+
+void ContractStore::put(const Pa2Record& rec)
+{
+	if (rec.kind == PA2_OPT_SETTLE)
+	{
+		Row row = { make_key(rec.product, rec.contractMonth, rec.type), rec.strike(), rec.settle() };
+		d_rows.push_back(row);
+		return;
+	}
+	MonthInfo info = { make_key(rec.product, rec.contractMonth, 0), false, 0.0, 0, 0 };
+	if (rec.kind == PA2_FUT_SETTLE)
+	{
+		info.hasSettle = true;
+		info.futSettle = rec.settle();
+	}
+	else if (rec.kind == PA2_FUT_EXPIRY)
+		info.futExpiry = rec.expDate;
+	else if (rec.kind == PA2_OPT_EXPIRY)
+		info.optExpiry = rec.expDate;
+	else
+		return;
+	d_months.push_back(info);
+}
+
+void ContractStore::build()
+{
+	// options: sort by (contract, strike); stable, so that of two
+	// prices for the same strike the later one ends up last
+	stable_sort(d_rows.begin(), d_rows.end(), [](const Row& a, const Row& b) {
+		return a.key != b.key ? a.key < b.key : a.strike < b.strike;
+	});
+	size_t kept = 0;
+	for (size_t i = 0; i < d_rows.size(); ++i)
+	{
+		if (i + 1 < d_rows.size() && d_rows[i + 1].key == d_rows[i].key
+			&& d_rows[i + 1].strike == d_rows[i].strike)
+			continue;//superseded by a later price
+		d_rows[kept++] = d_rows[i];
+	}
+	d_rows.resize(kept);
+
+	d_strikes.resize(kept);
+	d_settles.resize(kept);
+	d_sliceKeys.clear();
+	d_slices.clear();
+	for (size_t i = 0; i < kept; ++i)
+	{
+		d_strikes[i] = d_rows[i].strike;
+		d_settles[i] = d_rows[i].settle;
+		if (i > 0 && d_rows[i].key == d_rows[i - 1].key)
+		{
+			++d_slices.back().size;
+			continue;
+		}
+		unsigned long long key = d_rows[i].key;
+		ContractSlice slice;
+		slice.product[0] = (char)(key >> 48);
+		slice.product[1] = (char)(key >> 40);
+		slice.product[2] = '\0';
+		slice.contractMonth = (int)((key >> 8) & 0xffffffff);
+		slice.type = (char)(key & 0xff);
+		slice.strikes = &d_strikes[i];
+		slice.settles = &d_settles[i];
+		slice.size = 1;
+		d_sliceKeys.push_back(key);
+		d_slices.push_back(slice);
+	}
+
+	// futures and expiries: merge the pieces of each month, later
+	// pieces overriding earlier ones
+	stable_sort(d_months.begin(), d_months.end(),
+		[](const MonthInfo& a, const MonthInfo& b) { return a.key < b.key; });
+	kept = 0;
+	for (size_t i = 0; i < d_months.size(); ++i)
+	{
+		if (kept == 0 || d_months[kept - 1].key != d_months[i].key)
+		{
+			d_months[kept++] = d_months[i];
+			continue;
+		}
+		MonthInfo& m = d_months[kept - 1];
+		if (d_months[i].hasSettle)
+		{
+			m.hasSettle = true;
+			m.futSettle = d_months[i].futSettle;
+		}
+		if (d_months[i].futExpiry)
+			m.futExpiry = d_months[i].futExpiry;
+		if (d_months[i].optExpiry)
+			m.optExpiry = d_months[i].optExpiry;
+	}
+	d_months.resize(kept);
+}
+
+const ContractSlice* ContractStore::find(const char* product, int yyyymm, char type) const
+{
+	unsigned long long key = make_key(product, yyyymm, type);
+	vector<unsigned long long>::const_iterator it =
+		lower_bound(d_sliceKeys.begin(), d_sliceKeys.end(), key);
+	if (it == d_sliceKeys.end() || *it != key)
+		return 0;
+	return &d_slices[it - d_sliceKeys.begin()];
+}
+
+void ContractStore::strike_range(const ContractSlice& slice, double lo, double hi,
+	size_t& first, size_t& last) const
+{
+	first = lower_bound(slice.strikes, slice.strikes + slice.size, lo) - slice.strikes;
+	last = upper_bound(slice.strikes + first, slice.strikes + slice.size, hi) - slice.strikes;
+}
+
+const ContractStore::MonthInfo* ContractStore::find_month(const char* product, int yyyymm) const
+{
+	unsigned long long key = make_key(product, yyyymm, 0);
+	size_t lo = 0, hi = d_months.size();
+	while (lo < hi)
+	{
+		size_t mid = (lo + hi) / 2;
+		if (d_months[mid].key < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == d_months.size() || d_months[lo].key != key)
+		return 0;
+	return &d_months[lo];
+}
+
+bool ContractStore::futures_settle(const char* product, int yyyymm, double& price) const
+{
+	const MonthInfo* m = find_month(product, yyyymm);
+	if (!m || !m->hasSettle)
+		return false;
+	price = m->futSettle;
+	return true;
+}
+
+int ContractStore::futures_expiry(const char* product, int yyyymm) const
+{
+	const MonthInfo* m = find_month(product, yyyymm);
+	return m ? m->futExpiry : 0;
+}
+
+int ContractStore::options_expiry(const char* product, int yyyymm) const
+{
+	const MonthInfo* m = find_month(product, yyyymm);
+	return m ? m->optExpiry : 0;
+}
@@ -0,0 +1,70 @@
+// File: ContractStore.h
+// Author(s): Jingyi Guo
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+#include "SpanParser.h"
+#ifndef _CONTRACT_STORE_
+#define _CONTRACT_STORE_
+
+// All option settlements of one (product, contract month, type),
+// strikes ascending.  The arrays live inside the ContractStore.
+struct ContractSlice {
+    char product[3];      // "CL", "NG"
+    int contractMonth;    // yyyymm
+    char type;            // 'C' or 'P'
+    const double* strikes;
+    const double* settles; // settles[i] goes with strikes[i]
+    size_t size;
+};
+
+// In-memory index of parsed pa2 records.  Fill it like any other
+// sink (or with ReadPa2Binary / ReadPa2Report), call build(), then
+// query: every lookup is a binary search over sorted arrays and
+// never allocates.  More records may be put() later; call build()
+// again and a repeated (contract, strike) keeps its latest price.
+class ContractStore : public Pa2RecordSink {
+public:
+    ContractStore();
+    void put(const Pa2Record&);
+    void build();
+
+    // 0 if there is no such slice
+    const ContractSlice* find(const char* product, int yyyymm, char type) const;
+    // strikes[first] .. strikes[last-1] are the strikes in [lo, hi]
+    void strike_range(const ContractSlice& slice, double lo, double hi,
+                      size_t& first, size_t& last) const;
+    // false if no futures settlement was seen
+    bool futures_settle(const char* product, int yyyymm, double& price) const;
+    int futures_expiry(const char* product, int yyyymm) const;  // yyyymmdd, 0 if unknown
+    int options_expiry(const char* product, int yyyymm) const;  // yyyymmdd, 0 if unknown
+
+    const vector<ContractSlice>& slices() const { return d_slices; }
+private:
+    ContractStore(const ContractStore&);            // slices point into
+    ContractStore& operator=(const ContractStore&); // our own arrays
+
+    struct Row {          // one option settlement as it arrived
+        unsigned long long key;
+        double strike;
+        double settle;
+    };
+    struct MonthInfo {    // futures settlement and expiries of a month
+        unsigned long long key;
+        bool hasSettle;
+        double futSettle;
+        int futExpiry;
+        int optExpiry;
+    };
+    static unsigned long long make_key(const char* product, int yyyymm, char type);
+    const MonthInfo* find_month(const char* product, int yyyymm) const;
+
+    vector<Row> d_rows;
+    vector<MonthInfo> d_months;          // one per month, sorted, after build()
+    vector<double> d_strikes;            // every slice's strikes, back to back
+    vector<double> d_settles;
+    vector<unsigned long long> d_sliceKeys;
+    vector<ContractSlice> d_slices;      // d_slices[i] has key d_sliceKeys[i]
+};
+#endif
@@ -3,34 +3,1028 @@
 // Author(s): Jingyi Guo
 
 #include <iostream>
+#include <cstddef>
+#include <vector>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+#include <initializer_list>
+#include <type_traits>
 using namespace std;
 #ifndef _DBL_LINK_LIST_
 #define _DBL_LINK_LIST_
-//Class definition
-class DoublyLinkedList {
+
+// define what each node looks like; next comes first, so a ring of
+// nodes is already a free list to a BasicDllNodePool
+template <class T>
+struct DllNode {
+    DllNode *next;
+    DllNode *prev;
+    T value;
+};
+
+template <class T> class BasicDllNodePool;
+
+// A list of T kept as a ring of nodes, d_ptr pointing at the front.
+// Nodes come from a BasicDllNodePool if the list is given one, and
+// from the allocator otherwise.  Iterators are bidirectional, and
+// reverse iterators walk the list the way put_rev does.
+// For numbers, the list also keeps its size and sum up to date, and
+// with track_min_max() its min and max, so that all are O(1); their
+// iterators only read, so values change through the list alone.
+template <class T, class Alloc = allocator<T> >
+class BasicDoublyLinkedList {
+    static const bool Aggregates = is_arithmetic<T>::value;
+    typedef typename conditional<is_integral<T>::value, long long, double>::type Total;
 public:
-    DoublyLinkedList();        // default constructor
-    DoublyLinkedList(int);     // construct a one-node list
-    DoublyLinkedList(int,int); // construct a two-node list
+    typedef T value_type;
+    typedef Alloc allocator_type;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename conditional<Aggregates, const T &, T &>::type reference;
+    typedef const T &const_reference;
+    typedef DllNode<T> Data;
+    typedef BasicDllNodePool<T> Pool;
+    template <bool Const> class Iterator;
+    typedef Iterator<Aggregates> iterator;
+    typedef Iterator<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    BasicDoublyLinkedList();   // default constructor
+    explicit BasicDoublyLinkedList(const Alloc &);
+    explicit BasicDoublyLinkedList(Pool &); // empty list whose nodes
+                               // come from a pool
+    BasicDoublyLinkedList(const T &);            // construct a one-node list
+    BasicDoublyLinkedList(const T &, const T &); // construct a two-node list
+    // from a range or a list of values; with a pool, the nodes are one
+    // contiguous run taken from it in one step
+    template <class It, class = typename iterator_traits<It>::iterator_category>
+    BasicDoublyLinkedList(It first, It last);
+    template <class It, class = typename iterator_traits<It>::iterator_category>
+    BasicDoublyLinkedList(It first, It last, Pool &);
+    BasicDoublyLinkedList(initializer_list<T>);
+    BasicDoublyLinkedList(initializer_list<T>, Pool &);
+    BasicDoublyLinkedList(const BasicDoublyLinkedList &);
+    BasicDoublyLinkedList &operator=(const BasicDoublyLinkedList &); // reuses our nodes
+    BasicDoublyLinkedList(BasicDoublyLinkedList &&);            // take other's nodes (and
+    BasicDoublyLinkedList &operator=(BasicDoublyLinkedList &&); // pool), leaving it empty
+    ~BasicDoublyLinkedList();
+
     void put_rev(ostream &) const;   // display the list in reverse
                                // to some ostream
-    struct Data;
-	friend ostream& operator <<(ostream&, const DoublyLinkedList&);
-	~DoublyLinkedList();
-	void push_back(int);
-	void pop_back();
-	void push_front(int);
-	void pop_front();
-	int front() const;
-	int back() const;
-	DoublyLinkedList(const DoublyLinkedList&);
-	DoublyLinkedList& operator=(const DoublyLinkedList&);
-	int size() const;
-	int min() const;
-	int max() const;
-	int sum() const;
-	double mean() const;
+    template <class U, class A>
+    friend ostream &operator<<(ostream &, const BasicDoublyLinkedList<U, A> &);
+
+    // push_back and push_front hand back an iterator to the new value:
+    // a handle that stays good, however the list changes around it,
+    // until that value is erased or popped, for O(1) erase and insert
+    // next to it later.  Handles keep working with erase and insert
+    // on whichever list their node is in after a move or a splice;
+    // only ++ and -- on them, which go by the list they came from,
+    // will not do.
+    iterator push_back(const T &val) { emplace_back(val); return iterator(d_ptr->prev, this); }
+    iterator push_back(T &&val) { emplace_back(std::move(val)); return iterator(d_ptr->prev, this); }
+    iterator push_front(const T &val) { emplace_front(val); return begin(); }
+    iterator push_front(T &&val) { emplace_front(std::move(val)); return begin(); }
+    template <class... Args> reference emplace_back(Args &&...);  // T(args...)
+    template <class... Args> reference emplace_front(Args &&...); // in a new node
+    template <class... Args> iterator emplace(const_iterator pos, Args &&...); // before pos
+    iterator insert_before(const_iterator pos, const T &val) { return emplace(pos, val); }
+    iterator insert_before(const_iterator pos, T &&val) { return emplace(pos, std::move(val)); }
+    iterator insert_after(const_iterator pos, const T &val) { return emplace(after(pos), val); }
+    iterator insert_after(const_iterator pos, T &&val) { return emplace(after(pos), std::move(val)); }
+    iterator erase(const_iterator pos); // returns the one after it
+    void pop_back();
+    void pop_front();
+    const T &front() const;    // 0 if an empty list of numbers;
+    const T &back() const;     // other lists must not be empty
+
+    iterator begin() { return iterator(d_ptr, this); }
+    iterator end() { return iterator(0, this); }
+    const_iterator begin() const { return const_iterator(d_ptr, this); }
+    const_iterator end() const { return const_iterator(0, this); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+    // Move other's nodes (all of them, or [first, last)) in front of
+    // pos, which may be end().  Nodes are relinked, not copied, when
+    // both lists draw on the same pool (or equal allocators); that is
+    // O(1) for a whole list, or for a range within one list.  For
+    // numbers, a range from another list is walked once for its sum,
+    // and with min/max tracking on the tracking is rebuilt, in O(n).
+    void splice(const_iterator pos, BasicDoublyLinkedList &other);
+    void splice(const_iterator pos, BasicDoublyLinkedList &other,
+                const_iterator first, const_iterator last);
+
+    bool empty() const { return d_ptr == 0; }
+    int size() const { return d_size; }
+    // numbers only: size, sum and mean are kept up to date as the list
+    // changes, O(1).  min and max walk the list, unless it tracks them;
+    // tracking stays O(1) at the ends, but an insert or erase anywhere
+    // else rebuilds it, O(n)
+    T min() const;
+    T max() const;
+    T sum() const { static_assert(Aggregates, "sum of numbers only"); return (T)d_sum; }
+    double mean() const { static_assert(Aggregates, "mean of numbers only"); return d_sum / (double)d_size; }
+    void track_min_max(bool on = true); // O(1) min and max from now on,
+                               // for a little more work on every push and pop
+    bool tracks_min_max() const { return d_minmax != 0; }
+    allocator_type get_allocator() const { return allocator_type(d_alloc); }
 private:
+    typedef typename allocator_traits<Alloc>::template rebind_alloc<Data> NodeAlloc;
+    typedef allocator_traits<NodeAlloc> NodeTraits;
+    struct MinMax;
+
+    template <class... Args> Data *new_node(Args &&...);
+    void free_node(Data *);
+    void clear();              // free every node, all at once if pooled
+    void counted_in(const T &, bool atFront);
+    void counted_out(bool atFront);  // before the node at that end goes
+    void split_min_max(int);   // refill both MinMax stacks from the list
+    Data *new_run(size_t);     // that many raw nodes, linked by next only
+    void link_run(Data *, size_t);   // filled in new_run nodes, at the back
+    void free_run(Data *, Data *);   // unlinked first to last, inclusive
+    void unlink_range(Data *, Data *);
+    void link_range(Data *, Data *, Data *); // first to last before a
+                               // node, or at the back if it is 0
+    const_iterator after(const_iterator pos) const  // by our ring, not pos's list
+    {
+        return const_iterator(pos.d_node == d_ptr->prev ? 0 : pos.d_node->next, this);
+    }
+    bool shares_nodes(const BasicDoublyLinkedList &other) const
+    {
+        return d_pool == other.d_pool && (d_pool || d_alloc == other.d_alloc);
+    }
+    template <class It> void append(It, It, input_iterator_tag);
+    template <class It> void append(It, It, forward_iterator_tag);
+
     Data *d_ptr;               // a pointer to some Data
+    Pool *d_pool;              // 0: nodes come from the allocator
+    NodeAlloc d_alloc;
+    int d_size;
+    Total d_sum;               // numbers only; sum() is its low part
+    MinMax *d_minmax;          // 0 unless tracking min and max
+};
+
+typedef BasicDoublyLinkedList<int> DoublyLinkedList;
+
+// Nodes for any number of lists of T, carved out of slabs of
+// nodesPerSlab at a time.  A freed node goes on a free list threaded
+// through the nodes themselves and is the next one handed out; a
+// whole list is freed in one step by splicing its ring onto the free
+// list.  Slabs are only given back by the pool's destructor, so it
+// has to outlive its lists.  Not thread safe: share a pool between
+// lists of one thread only.
+template <class T>
+class BasicDllNodePool {
+public:
+    typedef DllNode<T> Node;   // handed out raw: values are the list's job
+
+    BasicDllNodePool(size_t nodesPerSlab = 4096);
+    ~BasicDllNodePool();
+    Node *allocate();
+    Node *allocate_run(size_t); // contiguous if it can, linked by next
+    void deallocate(Node *);
+    void deallocate_ring(Node *); // a node and all it links to,
+                               // following next around the ring
+    size_t slabs() const { return d_slabs.size(); }
+private:
+    BasicDllNodePool(const BasicDllNodePool &);
+    BasicDllNodePool &operator=(const BasicDllNodePool &);
+    Node *new_slab(size_t);
+
+    size_t d_slabSize;
+    vector<Node *> d_slabs;
+    Node *d_free;              // free list, linked by next
+    Node *d_unused;            // rest of the newest slab,
+    Node *d_end;               // never handed out yet
+};
+
+typedef BasicDllNodePool<int> DllNodePool;
+
+/* ---------------- iterators ----------------- */
+
+template <class T, class Alloc>
+template <bool Const>
+class BasicDoublyLinkedList<T, Alloc>::Iterator {
+public:
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename conditional<Const, const T *, T *>::type pointer;
+    typedef typename conditional<Const, const T &, T &>::type reference;
+
+    Iterator() : d_node(0), d_list(0) { }
+    Iterator(const Iterator<false> &other) : d_node(other.d_node), d_list(other.d_list) { }
+    reference operator*() const { return d_node->value; }
+    pointer operator->() const { return &d_node->value; }
+    Iterator &operator++()
+    {
+        d_node = d_node->next == d_list->d_ptr ? 0 : d_node->next;
+        return *this;
+    }
+    Iterator operator++(int) { Iterator was(*this); ++*this; return was; }
+    Iterator &operator--()
+    {
+        d_node = d_node ? d_node->prev : d_list->d_ptr->prev;
+        return *this;
+    }
+    Iterator operator--(int) { Iterator was(*this); --*this; return was; }
+    bool operator==(const Iterator &other) const { return d_node == other.d_node; }
+    bool operator!=(const Iterator &other) const { return d_node != other.d_node; }
+private:
+    friend class BasicDoublyLinkedList;
+    friend class Iterator<!Const>;
+    Iterator(Data *node, const BasicDoublyLinkedList *list) : d_node(node), d_list(list) { }
+
+    Data *d_node;              // 0 past the back
+    const BasicDoublyLinkedList *d_list;
 };
+
+/* ---------------- min and max ----------------- */
+
+// O(1) min and max with pushes and pops at both ends.  The list is
+// split between two stacks: its front part stacked from the middle
+// out to the front, its back part from the middle out to the back.
+// Each entry holds the min and max of its stack up to and including
+// itself, so the tops of the two stacks give the list's.  Popping
+// from a side whose stack is empty splits the list between the two
+// stacks again; the next split is at least half the list's length
+// of pops away, so pops stay O(1) amortised.
+template <class T, class Alloc>
+struct BasicDoublyLinkedList<T, Alloc>::MinMax {
+    struct Extremes {
+        T min;
+        T max;
+    };
+    vector<Extremes> front;
+    vector<Extremes> back;
+
+    static void push(vector<Extremes> &stack, const T &val)
+    {
+        Extremes e = { val, val };
+        if (!stack.empty())
+        {
+            e.min = stack.back().min < val ? stack.back().min : val;
+            e.max = stack.back().max > val ? stack.back().max : val;
+        }
+        stack.push_back(e);
+    }
+};
+
+/* ---------------- BasicDoublyLinkedList ----------------- */
+
+// default constructor: empty list
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList()
+: d_ptr(0), d_pool(0), d_alloc(), d_size(0), d_sum(0), d_minmax(0)  // sets d_ptr to point nowhere
+{ }
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(const Alloc &alloc)
+: d_ptr(0), d_pool(0), d_alloc(alloc), d_size(0), d_sum(0), d_minmax(0)
+{ }
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(Pool &pool)
+: d_ptr(0), d_pool(&pool), d_alloc(), d_size(0), d_sum(0), d_minmax(0)
+{ }
+
+// constructor for a one-node (one value) list
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(const T &val)
+: BasicDoublyLinkedList()
+{
+    push_back(val);
+}
+
+// constructor for a two-node (two value) list
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(const T &val1, const T &val2)
+: BasicDoublyLinkedList()
+{
+    push_back(val1);
+    push_back(val2);
+}
+
+template <class T, class Alloc>
+template <class It, class>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(It first, It last)
+: BasicDoublyLinkedList()
+{
+    append(first, last, typename iterator_traits<It>::iterator_category());
+}
+
+template <class T, class Alloc>
+template <class It, class>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(It first, It last, Pool &pool)
+: BasicDoublyLinkedList(pool)
+{
+    append(first, last, typename iterator_traits<It>::iterator_category());
+}
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(initializer_list<T> values)
+: BasicDoublyLinkedList()
+{
+    append(values.begin(), values.end(), random_access_iterator_tag());
+}
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(initializer_list<T> values, Pool &pool)
+: BasicDoublyLinkedList(pool)
+{
+    append(values.begin(), values.end(), random_access_iterator_tag());
+}
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(const BasicDoublyLinkedList &other)
+: d_ptr(0), d_pool(other.d_pool),  // a copy draws on the same pool
+  d_alloc(NodeTraits::select_on_container_copy_construction(other.d_alloc)),
+  d_size(0), d_sum(0), d_minmax(other.d_minmax ? new MinMax : 0)
+{
+    append(other.begin(), other.end(), forward_iterator_tag());
+}
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc> &BasicDoublyLinkedList<T, Alloc>::operator=(const BasicDoublyLinkedList &other)
+{
+    if (this == &other)
+        return *this;
+    if (!other.d_ptr)
+    {
+        clear();
+        return *this;
+    }
+    // write over the nodes we have, then free the ones left or add the rest
+    Data *mine = d_ptr, *theirs = other.d_ptr;
+    int n = 0;
+    for (; n < d_size && n < other.d_size; ++n, mine = mine->next, theirs = theirs->next)
+        mine->value = theirs->value;
+    if (n < d_size)
+    {
+        Data *last = d_ptr->prev;
+        unlink_range(mine, last);
+        free_run(mine, last);
+    }
+    d_size = n;
+    if (n < other.d_size)
+    {
+        size_t rest = other.d_size - n;
+        Data *run = new_run(rest), *p = run;
+        for (size_t i = 0; i < rest; ++i, theirs = theirs->next)
+        {
+            NodeTraits::construct(d_alloc, &p->value, theirs->value);
+            if (i + 1 < rest)
+                p = p->next;
+        }
+        link_run(run, rest);
+    }
+    d_sum = other.d_sum;
+    if (d_minmax)
+        split_min_max(d_size / 2);
+    return *this;
+}
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::BasicDoublyLinkedList(BasicDoublyLinkedList &&other)
+: d_ptr(other.d_ptr), d_pool(other.d_pool), d_alloc(std::move(other.d_alloc)),
+  d_size(other.d_size), d_sum(other.d_sum), d_minmax(other.d_minmax)
+{
+    other.d_ptr = 0;
+    other.d_size = 0;
+    other.d_sum = 0;
+    other.d_minmax = 0;
+}
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc> &BasicDoublyLinkedList<T, Alloc>::operator=(BasicDoublyLinkedList &&other)
+{
+    if (this == &other)
+        return *this;
+    clear();
+    delete d_minmax;
+    d_ptr = other.d_ptr;
+    d_pool = other.d_pool;
+    d_alloc = std::move(other.d_alloc);
+    d_size = other.d_size;
+    d_sum = other.d_sum;
+    d_minmax = other.d_minmax;
+    other.d_ptr = 0;
+    other.d_size = 0;
+    other.d_sum = 0;
+    other.d_minmax = 0;
+    return *this;
+}
+
+template <class T, class Alloc>
+BasicDoublyLinkedList<T, Alloc>::~BasicDoublyLinkedList()  // destructor
+{
+    clear();
+    delete d_minmax;
+}
+
+// display the list in reverse
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::put_rev(ostream &os) const
+{
+    if (!d_ptr) return;  // empty list: do nothing
+
+    // display the rest of the nodes in reverse, until we
+    // have circled back to the first node again
+    for (Data *p(d_ptr->prev); p != d_ptr; p = p->prev)
+        os << p->value << " ";
+    // finally, display the first node's value
+    os << d_ptr->value;
+}
+
+template <class T, class Alloc>
+ostream &operator<<(ostream &os, const BasicDoublyLinkedList<T, Alloc> &list)
+{
+    typedef typename BasicDoublyLinkedList<T, Alloc>::Data Data;
+    if (!list.d_ptr) return os;
+    Data *p = list.d_ptr;
+    for (; p != list.d_ptr->prev; p = p->next)
+        os << p->value << " ";
+    os << p->value;
+    return os;
+}
+
+template <class T, class Alloc>
+template <class... Args>
+typename BasicDoublyLinkedList<T, Alloc>::Data *BasicDoublyLinkedList<T, Alloc>::new_node(Args &&...args)
+{
+    Data *node = d_pool ? d_pool->allocate() : NodeTraits::allocate(d_alloc, 1);
+    NodeTraits::construct(d_alloc, &node->value, std::forward<Args>(args)...);
+    return node;
+}
+
+template <class T, class Alloc>
+inline void BasicDoublyLinkedList<T, Alloc>::free_node(Data *node)
+{
+    NodeTraits::destroy(d_alloc, &node->value);
+    if (d_pool)
+        d_pool->deallocate(node);
+    else
+        NodeTraits::deallocate(d_alloc, node, 1);
+}
+
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::clear()
+{
+    d_size = 0;
+    d_sum = 0;
+    if (d_minmax)
+    {
+        d_minmax->front.clear();
+        d_minmax->back.clear();
+    }
+    if (!d_ptr) return;
+    free_run(d_ptr, d_ptr->prev);  // the whole ring at once if pooled
+    d_ptr = 0;
+}
+
+template <class T, class Alloc>
+inline void BasicDoublyLinkedList<T, Alloc>::counted_in(const T &val, bool atFront)
+{
+    ++d_size;
+    if constexpr (Aggregates)
+    {
+        d_sum += val;
+        if (d_minmax)
+            MinMax::push(atFront ? d_minmax->front : d_minmax->back, val);
+    }
+}
+
+template <class T, class Alloc>
+inline void BasicDoublyLinkedList<T, Alloc>::counted_out(bool atFront)
+{
+    if constexpr (Aggregates)
+    {
+        if (d_minmax)
+        {
+            vector<typename MinMax::Extremes> &side = atFront ? d_minmax->front : d_minmax->back;
+            if (side.empty())
+                split_min_max(atFront ? (d_size + 1) / 2 : d_size / 2);
+            side.pop_back();
+        }
+        d_sum -= atFront ? d_ptr->value : d_ptr->prev->value;
+    }
+    --d_size;
+}
+
+template <class T, class Alloc>
+typename BasicDoublyLinkedList<T, Alloc>::Data *BasicDoublyLinkedList<T, Alloc>::new_run(size_t n)
+{
+    if (d_pool)
+        return d_pool->allocate_run(n);
+    Data *first = NodeTraits::allocate(d_alloc, 1), *p = first;
+    for (size_t i = 1; i < n; ++i, p = p->next)
+        p->next = NodeTraits::allocate(d_alloc, 1);
+    return first;
+}
+
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::link_run(Data *first, size_t n)
+{
+    Data *p = first;
+    for (size_t i = 1; ; ++i, p = p->next)
+    {
+        counted_in(p->value, false);
+        if (i == n)
+            break;
+        p->next->prev = p;
+    }
+    link_range(0, first, p);
+}
+
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::free_run(Data *first, Data *last)
+{
+    if (!d_pool || !is_trivially_destructible<T>::value)
+        for (Data *p = first, *next; ; p = next)
+        {
+            next = p->next;
+            bool done = p == last;
+            if (d_pool)
+                NodeTraits::destroy(d_alloc, &p->value);
+            else
+                free_node(p);
+            if (done)
+                break;
+        }
+    if (d_pool)
+    {
+        last->next = first;  // make it a ring
+        first->prev = last;
+        d_pool->deallocate_ring(first);
+    }
+}
+
+// take first..last out of the ring; size and sum are up to the caller
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::unlink_range(Data *first, Data *last)
+{
+    if (first == d_ptr && last == d_ptr->prev)  // all of it
+    {
+        d_ptr = 0;
+        return;
+    }
+    first->prev->next = last->next;
+    last->next->prev = first->prev;
+    if (first == d_ptr)
+        d_ptr = last->next;
+}
+
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::link_range(Data *pos, Data *first, Data *last)
+{
+    if (!d_ptr)
+    {
+        first->prev = last;
+        last->next = first;
+        d_ptr = first;
+        return;
+    }
+    Data *after = pos ? pos : d_ptr;  // in front of the first node is also at the back
+    first->prev = after->prev;
+    after->prev->next = first;
+    last->next = after;
+    after->prev = last;
+    if (pos == d_ptr)
+        d_ptr = first;
+}
+
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::split_min_max(int frontCount)
+{
+    if constexpr (Aggregates)
+    {
+        d_minmax->front.clear();
+        d_minmax->back.clear();
+        Data *middle = d_ptr;  // first node of the back part
+        for (int i = 0; i < frontCount; ++i)
+            middle = middle->next;
+        Data *p = middle;
+        for (int i = 0; i < frontCount; ++i)  // middle out to the front
+        {
+            p = p->prev;
+            MinMax::push(d_minmax->front, p->value);
+        }
+        p = middle;
+        for (int i = frontCount; i < d_size; ++i, p = p->next)  // middle out to the back
+            MinMax::push(d_minmax->back, p->value);
+    }
+}
+
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::track_min_max(bool on)
+{
+    static_assert(Aggregates, "min and max of numbers only");
+    if (on && !d_minmax)
+    {
+        d_minmax = new MinMax;
+        split_min_max(d_size / 2);
+    }
+    else if (!on)
+    {
+        delete d_minmax;
+        d_minmax = 0;
+    }
+}
+
+template <class T, class Alloc>
+template <class... Args>
+typename BasicDoublyLinkedList<T, Alloc>::reference BasicDoublyLinkedList<T, Alloc>::emplace_back(Args &&...args)
+{
+    Data *newback = new_node(std::forward<Args>(args)...);
+    counted_in(newback->value, false);
+    if (!d_ptr)
+    {
+        d_ptr = newback;
+        d_ptr->next = d_ptr;
+        d_ptr->prev = d_ptr;
+        return newback->value;
+    }
+    Data *nowback = d_ptr->prev;
+    newback->prev = nowback;
+    newback->next = d_ptr;
+    nowback->next = newback;
+    d_ptr->prev = newback;
+    return newback->value;
+}
+
+template <class T, class Alloc>
+template <class... Args>
+typename BasicDoublyLinkedList<T, Alloc>::reference BasicDoublyLinkedList<T, Alloc>::emplace_front(Args &&...args)
+{
+    Data *newfirst = new_node(std::forward<Args>(args)...);
+    counted_in(newfirst->value, true);
+    if (!d_ptr)
+    {
+        d_ptr = newfirst;
+        d_ptr->next = d_ptr;
+        d_ptr->prev = d_ptr;
+        return newfirst->value;
+    }
+    Data *nowfirst = d_ptr;
+    newfirst->prev = nowfirst->prev;
+    newfirst->next = nowfirst;
+    d_ptr = newfirst;
+    nowfirst->prev->next = newfirst;
+    nowfirst->prev = newfirst;
+    return newfirst->value;
+}
+
+template <class T, class Alloc>
+template <class... Args>
+typename BasicDoublyLinkedList<T, Alloc>::iterator BasicDoublyLinkedList<T, Alloc>::emplace(const_iterator pos, Args &&...args)
+{
+    if (!pos.d_node)
+    {
+        emplace_back(std::forward<Args>(args)...);
+        return iterator(d_ptr->prev, this);
+    }
+    if (pos.d_node == d_ptr)
+    {
+        emplace_front(std::forward<Args>(args)...);
+        return begin();
+    }
+    Data *node = new_node(std::forward<Args>(args)...);
+    link_range(pos.d_node, node, node);
+    ++d_size;
+    if constexpr (Aggregates)
+    {
+        d_sum += node->value;
+        if (d_minmax)
+            split_min_max(d_size / 2);
+    }
+    return iterator(node, this);
+}
+
+template <class T, class Alloc>
+typename BasicDoublyLinkedList<T, Alloc>::iterator BasicDoublyLinkedList<T, Alloc>::erase(const_iterator pos)
+{
+    Data *node = pos.d_node;
+    if (node == d_ptr)
+    {
+        pop_front();
+        return begin();
+    }
+    if (node == d_ptr->prev)
+    {
+        pop_back();
+        return end();
+    }
+    Data *next = node->next;
+    unlink_range(node, node);
+    --d_size;
+    if constexpr (Aggregates)
+    {
+        d_sum -= node->value;
+        if (d_minmax)
+            split_min_max(d_size / 2);
+    }
+    free_node(node);
+    return iterator(next, this);
+}
+
+template <class T, class Alloc>
+inline void BasicDoublyLinkedList<T, Alloc>::pop_back()
+{
+    if (!d_ptr)
+        return;
+    counted_out(false);
+    if (d_ptr == d_ptr->next)
+    {
+        free_node(d_ptr);
+        d_ptr = 0;
+        return;
+    }
+    Data *last = d_ptr->prev;
+    Data *second_to_last = d_ptr->prev->prev;
+    d_ptr->prev = second_to_last;
+    second_to_last->next = d_ptr;
+    free_node(last);
+}
+
+template <class T, class Alloc>
+inline void BasicDoublyLinkedList<T, Alloc>::pop_front()
+{
+    if (!d_ptr)
+        return;
+    counted_out(true);
+    if (d_ptr == d_ptr->next)
+    {
+        free_node(d_ptr);
+        d_ptr = 0;
+        return;
+    }
+    Data *first = d_ptr;
+    Data *second = d_ptr->next;
+    first->prev->next = second;
+    second->prev = first->prev;
+    d_ptr = second;
+    free_node(first);
+}
+
+template <class T, class Alloc>
+inline const T &BasicDoublyLinkedList<T, Alloc>::front() const
+{
+    if constexpr (Aggregates)
+        if (!d_ptr)
+        {
+            static const T none = T();
+            return none;
+        }
+    return d_ptr->value;
+}
+
+template <class T, class Alloc>
+inline const T &BasicDoublyLinkedList<T, Alloc>::back() const
+{
+    if constexpr (Aggregates)
+        if (!d_ptr)
+        {
+            static const T none = T();
+            return none;
+        }
+    return d_ptr->prev->value;
+}
+
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::splice(const_iterator pos, BasicDoublyLinkedList &other)
+{
+    if (&other == this || !other.d_ptr)
+        return;
+    if (!shares_nodes(other))
+    {
+        splice(pos, other, other.begin(), other.end());
+        return;
+    }
+    link_range(pos.d_node, other.d_ptr, other.d_ptr->prev);
+    d_size += other.d_size;
+    d_sum += other.d_sum;
+    other.d_ptr = 0;
+    other.clear();
+    if (d_minmax)
+        split_min_max(d_size / 2);
+}
+
+template <class T, class Alloc>
+void BasicDoublyLinkedList<T, Alloc>::splice(const_iterator pos, BasicDoublyLinkedList &other,
+                                             const_iterator first, const_iterator last)
+{
+    if (first == last)
+        return;
+    Data *from = first.d_node, *to = last.d_node ? last.d_node->prev : other.d_ptr->prev;
+    if (!shares_nodes(other))
+    {
+        // the nodes cannot change hands: move each value over and free its node
+        for (Data *p = from, *next; ; p = next)
+        {
+            next = p->next;
+            bool done = p == to;
+            Data *moved = new_node(std::move(p->value));
+            link_range(pos.d_node, moved, moved);
+            ++d_size;
+            other.unlink_range(p, p);
+            --other.d_size;
+            if constexpr (Aggregates)
+            {
+                d_sum += moved->value;
+                other.d_sum -= moved->value;
+            }
+            other.free_node(p);
+            if (done)
+                break;
+        }
+    }
+    else
+    {
+        if (&other != this)
+        {
+            int n = 0;
+            Total sum = 0;
+            for (Data *p = from; ; p = p->next)
+            {
+                ++n;
+                if constexpr (Aggregates)
+                    sum += p->value;
+                if (p == to)
+                    break;
+            }
+            other.d_size -= n;
+            other.d_sum -= sum;
+            d_size += n;
+            d_sum += sum;
+        }
+        other.unlink_range(from, to);
+        link_range(pos.d_node, from, to);
+    }
+    if (other.d_minmax && &other != this)
+        other.split_min_max(other.d_size / 2);
+    if (d_minmax)
+        split_min_max(d_size / 2);
+}
+
+template <class T, class Alloc>
+T BasicDoublyLinkedList<T, Alloc>::min() const
+{
+    static_assert(Aggregates, "min of numbers only");
+    if (!d_ptr)
+        return 0;
+    else if (d_minmax)
+    {
+        const vector<typename MinMax::Extremes> &front = d_minmax->front, &back = d_minmax->back;
+        if (front.empty() || back.empty())
+            return front.empty() ? back.back().min : front.back().min;
+        return front.back().min < back.back().min ? front.back().min : back.back().min;
+    }
+    else
+    {
+        T min = d_ptr->value;
+        for (Data *p = d_ptr; p->next != d_ptr; p = p->next)
+            min = p->value > min ? min : p->value;  // haven't compared the last one
+        min = d_ptr->prev->value > min ? min : d_ptr->prev->value;
+        return min;
+    }
+}
+
+template <class T, class Alloc>
+T BasicDoublyLinkedList<T, Alloc>::max() const
+{
+    static_assert(Aggregates, "max of numbers only");
+    if (!d_ptr)
+        return 0;
+    else if (d_minmax)
+    {
+        const vector<typename MinMax::Extremes> &front = d_minmax->front, &back = d_minmax->back;
+        if (front.empty() || back.empty())
+            return front.empty() ? back.back().max : front.back().max;
+        return front.back().max > back.back().max ? front.back().max : back.back().max;
+    }
+    else
+    {
+        T max = d_ptr->value;
+        for (Data *p = d_ptr; p->next != d_ptr; p = p->next)
+            max = p->value > max ? p->value : max;  // haven't compared the last one
+        max = d_ptr->prev->value > max ? d_ptr->prev->value : max;
+        return max;
+    }
+}
+
+// one pass only: no telling how many nodes there will be
+template <class T, class Alloc>
+template <class It>
+void BasicDoublyLinkedList<T, Alloc>::append(It first, It last, input_iterator_tag)
+{
+    for (; first != last; ++first)
+        emplace_back(*first);
+}
+
+template <class T, class Alloc>
+template <class It>
+void BasicDoublyLinkedList<T, Alloc>::append(It first, It last, forward_iterator_tag)
+{
+    size_t n = distance(first, last);
+    if (n == 0)
+        return;
+    Data *run = new_run(n);
+    Data *p = run;
+    for (size_t i = 0; i < n; ++i, ++first)
+    {
+        NodeTraits::construct(d_alloc, &p->value, *first);
+        if (i + 1 < n)         // the last next is not set yet
+            p = p->next;
+    }
+    link_run(run, n);
+}
+
+/* ---------------- BasicDllNodePool ----------------- */
+
+template <class T>
+BasicDllNodePool<T>::BasicDllNodePool(size_t nodesPerSlab)
+: d_slabSize(nodesPerSlab < 1 ? 1 : nodesPerSlab), d_free(0), d_unused(0), d_end(0)
+{ }
+
+template <class T>
+BasicDllNodePool<T>::~BasicDllNodePool()
+{
+    for (size_t i = 0; i < d_slabs.size(); ++i)
+        ::operator delete(d_slabs[i]);
+}
+
+template <class T>
+typename BasicDllNodePool<T>::Node *BasicDllNodePool<T>::new_slab(size_t n)
+{
+    d_slabs.push_back(static_cast<Node *>(::operator new(n * sizeof(Node))));
+    return d_slabs.back();
+}
+
+template <class T>
+inline typename BasicDllNodePool<T>::Node *BasicDllNodePool<T>::allocate()
+{
+    if (d_free)
+    {
+        Node *node = d_free;
+        d_free = node->next;
+        return node;
+    }
+    if (d_unused == d_end)  // hand out a fresh slab in address order
+    {
+        d_unused = new_slab(d_slabSize);
+        d_end = d_unused + d_slabSize;
+    }
+    return d_unused++;
+}
+
+template <class T>
+typename BasicDllNodePool<T>::Node *BasicDllNodePool<T>::allocate_run(size_t n)
+{
+    Node *run;
+    if ((size_t)(d_end - d_unused) >= n)  // contiguous out of this slab
+    {
+        run = d_unused;
+        d_unused += n;
+    }
+    else if (!d_free && n >= d_slabSize)  // or a slab of its own
+        run = new_slab(n);
+    else
+    {
+        // freed nodes first, then fresh ones, one at a time
+        run = allocate();
+        for (Node *p = run; --n > 0; p = p->next)
+            p->next = allocate();
+        return run;
+    }
+    for (size_t i = 0; i + 1 < n; ++i)
+        run[i].next = &run[i + 1];
+    return run;
+}
+
+template <class T>
+inline void BasicDllNodePool<T>::deallocate(Node *node)
+{
+    node->next = d_free;
+    d_free = node;
+}
+
+template <class T>
+void BasicDllNodePool<T>::deallocate_ring(Node *first)
+{
+    // the ring is already linked by next: cut it after its last node
+    Node *last = first->prev;
+    last->next = d_free;
+    d_free = first;
+}
+
+// the int list is compiled once, in DoublyLinkedList.cpp
+extern template class BasicDoublyLinkedList<int>;
+extern template class BasicDllNodePool<int>;
 #endif
\ No newline at end of file
@@ -0,0 +1,226 @@
+// File: Dual.h
+// Author(s): Jingyi Guo
+//
+// Forward-mode automatic differentiation.  A Dual<N> carries a value
+// and its gradient with respect to N inputs; a HyperDual<N> also
+// carries the Hessian, i.e. it is a second order Taylor expansion
+// in N directions.  Seed each input with its index, leave constants
+// unseeded, and run the ordinary formula:
+//     HyperDual<2> x(1.5, 0), y(2.0, 1);
+//     HyperDual<2> z = exp(x * y);   // z.d[1] = dz/dy, z.h[0][1] = d2z/dxdy
+// The Hessian is symmetric, so only its upper triangle is worked out.
+// Comparisons look at the values only, so branches follow the value.
+
+#include <cmath>
+using namespace std;
+#ifndef _DUAL_
+#define _DUAL_
+
+template <int N>
+struct Dual {
+    double v;           // value
+    double d[N];        // d[i] = dv/dx_i
+
+    Dual(double value = 0) : v(value)
+    {
+        for (int i = 0; i < N; ++i)
+            d[i] = 0;
+    }
+    Dual(double value, int input) : v(value)   // the input'th variable
+    {
+        for (int i = 0; i < N; ++i)
+            d[i] = i == input;
+    }
+};
+
+template <int N>
+struct HyperDual {
+    double v;           // value
+    double d[N];        // d[i] = dv/dx_i
+    double h[N][N];     // h[i][j] = d2v/dx_i dx_j, kept for i <= j only
+
+    HyperDual(double value = 0) : v(value)
+    {
+        for (int i = 0; i < N; ++i)
+        {
+            d[i] = 0;
+            for (int j = 0; j < N; ++j)
+                h[i][j] = 0;
+        }
+    }
+    HyperDual(double value, int input) : HyperDual(value)
+    {
+        d[input] = 1;
+    }
+};
+
+// f(x) given f, f' and f'' at x.v: every function below is one of these
+template <int N>
+inline Dual<N> Chain(const Dual<N>& x, double f, double df, double)
+{
+    Dual<N> r(f);
+    for (int i = 0; i < N; ++i)
+        r.d[i] = df * x.d[i];
+    return r;
+}
+
+template <int N>
+inline HyperDual<N> Chain(const HyperDual<N>& x, double f, double df, double d2f)
+{
+    HyperDual<N> r(f);
+    for (int i = 0; i < N; ++i)
+    {
+        r.d[i] = df * x.d[i];
+        for (int j = i; j < N; ++j)
+            r.h[i][j] = df * x.h[i][j] + d2f * x.d[i] * x.d[j];
+    }
+    return r;
+}
+
+/* ---------------- arithmetic ----------------- */
+
+template <int N>
+inline Dual<N> operator+(const Dual<N>& a, const Dual<N>& b)
+{
+    Dual<N> r(a.v + b.v);
+    for (int i = 0; i < N; ++i)
+        r.d[i] = a.d[i] + b.d[i];
+    return r;
+}
+
+template <int N>
+inline Dual<N> operator-(const Dual<N>& a, const Dual<N>& b)
+{
+    Dual<N> r(a.v - b.v);
+    for (int i = 0; i < N; ++i)
+        r.d[i] = a.d[i] - b.d[i];
+    return r;
+}
+
+template <int N>
+inline Dual<N> operator*(const Dual<N>& a, const Dual<N>& b)
+{
+    Dual<N> r(a.v * b.v);
+    for (int i = 0; i < N; ++i)
+        r.d[i] = a.d[i] * b.v + a.v * b.d[i];
+    return r;
+}
+
+template <int N>
+inline Dual<N> operator/(const Dual<N>& a, const Dual<N>& b)
+{
+    Dual<N> r(a.v / b.v);
+    for (int i = 0; i < N; ++i)
+        r.d[i] = (a.d[i] - r.v * b.d[i]) / b.v;
+    return r;
+}
+
+template <int N>
+inline HyperDual<N> operator+(const HyperDual<N>& a, const HyperDual<N>& b)
+{
+    HyperDual<N> r(a.v + b.v);
+    for (int i = 0; i < N; ++i)
+    {
+        r.d[i] = a.d[i] + b.d[i];
+        for (int j = i; j < N; ++j)
+            r.h[i][j] = a.h[i][j] + b.h[i][j];
+    }
+    return r;
+}
+
+template <int N>
+inline HyperDual<N> operator-(const HyperDual<N>& a, const HyperDual<N>& b)
+{
+    HyperDual<N> r(a.v - b.v);
+    for (int i = 0; i < N; ++i)
+    {
+        r.d[i] = a.d[i] - b.d[i];
+        for (int j = i; j < N; ++j)
+            r.h[i][j] = a.h[i][j] - b.h[i][j];
+    }
+    return r;
+}
+
+template <int N>
+inline HyperDual<N> operator*(const HyperDual<N>& a, const HyperDual<N>& b)
+{
+    HyperDual<N> r(a.v * b.v);
+    for (int i = 0; i < N; ++i)
+    {
+        r.d[i] = a.d[i] * b.v + a.v * b.d[i];
+        for (int j = i; j < N; ++j)
+            r.h[i][j] = a.h[i][j] * b.v + a.v * b.h[i][j] + a.d[i] * b.d[j] + a.d[j] * b.d[i];
+    }
+    return r;
+}
+
+template <int N>
+inline HyperDual<N> operator/(const HyperDual<N>& a, const HyperDual<N>& b)
+{
+    double inv = 1 / b.v;
+    return a * Chain(b, inv, -inv * inv, 2 * inv * inv * inv);
+}
+
+// mixed with plain numbers, and the unary and compound forms, for both
+#define _DUAL_MIXED_(D) \
+template <int N> inline D<N> operator+(const D<N>& a, double b) { return a + D<N>(b); } \
+template <int N> inline D<N> operator+(double a, const D<N>& b) { return D<N>(a) + b; } \
+template <int N> inline D<N> operator-(const D<N>& a, double b) { return a - D<N>(b); } \
+template <int N> inline D<N> operator-(double a, const D<N>& b) { return D<N>(a) - b; } \
+template <int N> inline D<N> operator*(const D<N>& a, double b) { return Chain(a, a.v * b, b, 0); } \
+template <int N> inline D<N> operator*(double a, const D<N>& b) { return Chain(b, a * b.v, a, 0); } \
+template <int N> inline D<N> operator/(const D<N>& a, double b) { return Chain(a, a.v / b, 1 / b, 0); } \
+template <int N> inline D<N> operator/(double a, const D<N>& b) { return D<N>(a) / b; } \
+template <int N> inline D<N> operator-(const D<N>& a) { return Chain(a, -a.v, -1, 0); } \
+template <int N> inline D<N>& operator+=(D<N>& a, const D<N>& b) { return a = a + b; } \
+template <int N> inline D<N>& operator-=(D<N>& a, const D<N>& b) { return a = a - b; } \
+template <int N> inline D<N>& operator*=(D<N>& a, const D<N>& b) { return a = a * b; } \
+template <int N> inline D<N>& operator/=(D<N>& a, const D<N>& b) { return a = a / b; } \
+template <int N> inline bool operator<(const D<N>& a, const D<N>& b) { return a.v < b.v; } \
+template <int N> inline bool operator>(const D<N>& a, const D<N>& b) { return a.v > b.v; } \
+template <int N> inline bool operator<=(const D<N>& a, const D<N>& b) { return a.v <= b.v; } \
+template <int N> inline bool operator>=(const D<N>& a, const D<N>& b) { return a.v >= b.v; } \
+template <int N> inline bool operator<(const D<N>& a, double b) { return a.v < b; } \
+template <int N> inline bool operator>(const D<N>& a, double b) { return a.v > b; } \
+template <int N> inline bool operator<=(const D<N>& a, double b) { return a.v <= b; } \
+template <int N> inline bool operator>=(const D<N>& a, double b) { return a.v >= b; }
+_DUAL_MIXED_(Dual)
+_DUAL_MIXED_(HyperDual)
+#undef _DUAL_MIXED_
+
+/* ---------------- functions ----------------- */
+
+#define _DUAL_FUNCTIONS_(D) \
+template <int N> inline D<N> exp(const D<N>& x) \
+{ \
+    double e = exp(x.v); \
+    return Chain(x, e, e, e); \
+} \
+template <int N> inline D<N> log(const D<N>& x) \
+{ \
+    return Chain(x, log(x.v), 1 / x.v, -1 / (x.v * x.v)); \
+} \
+template <int N> inline D<N> sqrt(const D<N>& x) \
+{ \
+    double s = sqrt(x.v); \
+    return Chain(x, s, 0.5 / s, -0.25 / (s * x.v)); \
+} \
+template <int N> inline D<N> pow(const D<N>& x, double p) \
+{ \
+    double f = pow(x.v, p); \
+    return Chain(x, f, p * f / x.v, p * (p - 1) * f / (x.v * x.v)); \
+} \
+template <int N> inline D<N> erf(const D<N>& x)   /* erf' = 2/sqrt(pi) e^(-x^2) */ \
+{ \
+    double df = 1.1283791670955126 * exp(-x.v * x.v); \
+    return Chain(x, erf(x.v), df, -2 * x.v * df); \
+} \
+template <int N> inline D<N> erfc(const D<N>& x) \
+{ \
+    double df = -1.1283791670955126 * exp(-x.v * x.v); \
+    return Chain(x, erfc(x.v), df, -2 * x.v * df); \
+}
+_DUAL_FUNCTIONS_(Dual)
+_DUAL_FUNCTIONS_(HyperDual)
+#undef _DUAL_FUNCTIONS_
+#endif
@@ -0,0 +1,110 @@
+// File: GzReader.cpp
+// Author(s): Jingyi Guo
+
+#include <zlib.h>
+#include <string>
+#include <vector>
+using namespace std;
+#include "GzReader.h"
+
+GzChunkReader::GzChunkReader(const vector<string>& files, int buffers, size_t bufferSize)
+: d_files(files), d_ring(buffers < 2 ? 2 : buffers), d_head(0), d_count(0),
+  d_holding(false), d_done(false), d_stop(false)
+{
+	for (size_t i = 0; i < d_ring.size(); ++i)
+		d_ring[i].buf.resize(bufferSize);
+	d_producer = thread(&GzChunkReader::produce, this);
+}
+
+GzChunkReader::~GzChunkReader()
+{
+	{
+		lock_guard<mutex> guard(d_lock);
+		d_stop = true;
+	}
+	d_freed.notify_all();
+	d_producer.join();
+}
+
+GzChunkReader::Slot* GzChunkReader::free_slot()
+{
+	unique_lock<mutex> guard(d_lock);
+	while (d_count == d_ring.size() && !d_stop)
+		d_freed.wait(guard);
+	if (d_stop)
+		return 0;
+	// the consumer never looks past d_count, so this slot is ours
+	// until publish()
+	return &d_ring[(d_head + d_count) % d_ring.size()];
+}
+
+void GzChunkReader::publish()
+{
+	{
+		lock_guard<mutex> guard(d_lock);
+		++d_count;
+	}
+	d_filled.notify_one();
+}
+
+void GzChunkReader::produce()
+{
+	for (size_t f = 0; f < d_files.size(); ++f)
+	{
+		gzFile gz = gzopen(d_files[f].c_str(), "rb");
+		if (gz)
+			gzbuffer(gz, 1 << 18);
+		bool endOfFile = false;
+		while (!endOfFile)
+		{
+			Slot* slot = free_slot();
+			if (!slot)
+			{
+				if (gz)
+					gzclose(gz);
+				return;
+			}
+			int n = gz ? gzread(gz, &slot->buf[0], (unsigned)slot->buf.size()) : -1;
+			slot->size = n > 0 ? n : 0;
+			slot->file = (int)f;
+			endOfFile = n <= 0 || gzeof(gz);
+			int err = Z_OK;
+			if (n >= 0 && endOfFile)
+				gzerror(gz, &err);//a cut or corrupt file ends early, but with an error
+			slot->failed = n < 0 || err != Z_OK;
+			slot->endOfFile = endOfFile;
+			publish();
+		}
+		if (gz)
+			gzclose(gz);
+	}
+	{
+		lock_guard<mutex> guard(d_lock);
+		d_done = true;
+	}
+	d_filled.notify_one();
+}
+
+bool GzChunkReader::next(Chunk& chunk)
+{
+	unique_lock<mutex> guard(d_lock);
+	if (d_holding)//hand the last chunk back
+	{
+		d_head = (d_head + 1) % d_ring.size();
+		--d_count;
+		d_holding = false;
+		d_freed.notify_one();
+	}
+	while (d_count == 0 && !d_done)
+		d_filled.wait(guard);
+	if (d_count == 0)
+		return false;
+	Slot& slot = d_ring[d_head];
+	d_holding = true;
+	chunk.data = slot.buf.empty() ? 0 : &slot.buf[0];
+	chunk.size = slot.size;
+	chunk.file = slot.file;
+	chunk.endOfFile = slot.endOfFile;
+	chunk.failed = slot.failed;
+	return true;
+}
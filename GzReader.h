@@ -0,0 +1,62 @@
+// File: GzReader.h
+// Author(s): Jingyi Guo
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+using namespace std;
+#ifndef _GZ_READER_
+#define _GZ_READER_
+
+// Reads a list of files (gzip'd or plain: zlib passes plain files
+// through) in a producer thread, which decompresses into a fixed
+// ring of buffers while the caller parses the chunks already done.
+// Memory use is the ring and nothing else, however many files.
+class GzChunkReader {
+public:
+    struct Chunk {
+        const char* data;
+        size_t size;
+        int file;           // index into the file list
+        bool endOfFile;     // last chunk of this file (size may be 0)
+        bool failed;        // the file could not be opened or read
+    };
+
+    GzChunkReader(const vector<string>& files, int buffers = 4,
+                  size_t bufferSize = 1 << 20);
+    ~GzChunkReader();       // stops the producer early if need be
+
+    // The next chunk, in file order; the chunk handed out by the
+    // previous call goes back to the producer.  false when done.
+    bool next(Chunk& chunk);
+private:
+    GzChunkReader(const GzChunkReader&);
+    GzChunkReader& operator=(const GzChunkReader&);
+
+    struct Slot {
+        vector<char> buf;
+        size_t size;
+        int file;
+        bool endOfFile;
+        bool failed;
+    };
+    void produce();
+    Slot* free_slot();      // producer: wait for room; 0 if stopping
+    void publish();
+
+    vector<string> d_files;
+    vector<Slot> d_ring;
+    size_t d_head;          // oldest filled slot
+    size_t d_count;         // filled slots, including one held by the caller
+    bool d_holding;
+    bool d_done;            // producer has finished every file
+    bool d_stop;            // destructor wants the producer gone
+    mutex d_lock;
+    condition_variable d_filled;
+    condition_variable d_freed;
+    thread d_producer;
+};
+#endif
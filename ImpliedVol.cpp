@@ -0,0 +1,302 @@
+// File: ImpliedVol.cpp
+// Author(s): Jingyi Guo
+//
+// Everything is done on the normalised Black price
+//     b(x, s) = e^(x/2) Phi(x/s + s/2) - e^(-x/2) Phi(x/s - s/2)
+// with x = ln(F/K) and s = sigma sqrt(T), which is the undiscounted
+// price divided by sqrt(F K).  In-the-money options are turned into
+// out-of-the-money calls (x <= 0) by taking off the intrinsic value.
+
+#include <cmath>
+#include <cfloat>
+#include <limits>
+#include <chrono>
+using namespace std;
+#include "ImpliedVol.h"
+
+static const double OneOverSqrtTwoPi = 0.39894228040143267794;
+
+// Phi without the cancellation of 1/2 + erf/2 in the left tail
+static double Phi(double x)
+{
+	return 0.5 * erfc(-x / M_SQRT2);
+}
+
+// Acklam's rational approximation of the inverse of Phi, polished
+// with one Halley step
+static double InversePhi(double p)
+{
+	static const double a[] = { -3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+		1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00 };
+	static const double b[] = { -5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+		6.680131188771972e+01, -1.328068155288572e+01 };
+	static const double c[] = { -7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+		-2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00 };
+	static const double d[] = { 7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+		3.754408661907416e+00 };
+	double x;
+	if (p < 0.02425)
+	{
+		double q = sqrt(-2 * log(p));
+		x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+			/ ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+	}
+	else if (p <= 1 - 0.02425)
+	{
+		double q = p - 0.5;
+		double r = q * q;
+		x = (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q
+			/ (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+	}
+	else
+	{
+		double q = sqrt(-2 * log1p(-p));
+		x = -(((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5])
+			/ ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+	}
+	double e = Phi(x) - p;
+	double u = e / (OneOverSqrtTwoPi * exp(-x * x / 2));
+	return x - u / (1 + x * u / 2);
+}
+
+// ex is exp(x/2), passed in because x stays put while s moves
+static double NormalisedCall(double x, double s, double ex)
+{
+	if (s <= 0)
+		return fmax(ex - 1 / ex, 0.0);
+	return ex * Phi(x / s + s / 2) - Phi(x / s - s / 2) / ex;
+}
+
+// db/ds
+static double NormalisedVega(double x, double s)
+{
+	return OneOverSqrtTwoPi * exp(-0.5 * (x * x / (s * s) + s * s / 4));
+}
+
+IVResult Black76ImpliedVol(double price, double f, double k, double r, double t, char cp)
+{
+	IVResult result = { numeric_limits<double>::quiet_NaN(), IV_BAD_INPUT, 0 };
+	if (!(f > 0) || !(k > 0) || !(t > 0) || !(price >= 0) || !isfinite(price) || !isfinite(r)
+		|| !isfinite(f) || !isfinite(k) || !isfinite(t))
+		return result;
+
+	double beta = price * exp(r * t) / sqrt(f * k);
+	double x = log(f / k);
+	double intrinsic = fmax((cp == 'P' ? -2 : 2) * sinh(x / 2), 0.0);
+	double maximum = exp((cp == 'P' ? -x : x) / 2);
+	if (beta < intrinsic)
+	{
+		result.status = IV_BELOW_INTRINSIC;
+		return result;
+	}
+	if (beta >= maximum)
+	{
+		result.status = IV_ABOVE_MAXIMUM;
+		return result;
+	}
+	result.status = IV_OK;
+	// what is left is the price of an out-of-the-money call
+	beta -= intrinsic;
+	x = -fabs(x);
+	if (beta <= 0)
+	{
+		result.vol = 0;
+		return result;
+	}
+
+	// Initial guess, on either side of the inflection point sc of
+	// b(s): below it ln b is nearly linear in 1/s^2, above it the
+	// gap to the maximum behaves like Phi(-s/2).
+	double bmax = exp(x / 2);
+	double sc = sqrt(2 * fabs(x));
+	double bc = NormalisedCall(x, sc, bmax);
+	bool lower = beta < bc;
+	double s;
+	if (lower)
+	{
+		// b(x, s) <= b(0, s) <= s / sqrt(2 pi) bounds s from below, which
+		// the asymptote alone does not near the money
+		s = sqrt(2 * x * x / (fabs(x) - 4 * log(beta / bc)));
+		s = fmax(s, beta / OneOverSqrtTwoPi);
+	}
+	else
+		s = -2 * InversePhi((bmax - beta) / (bmax - bc) * Phi(-sc / 2));
+
+	// Householder steps on g = ln b - ln beta (lower) or b - beta (upper),
+	// until the step is down to rounding noise in b
+	double lastStep = numeric_limits<double>::infinity();
+	for (int i = 0; i < IV_MAX_ITERATIONS; ++i)
+	{
+		double b = NormalisedCall(x, s, bmax);
+		double vega = NormalisedVega(x, s);
+		double h2 = x * x / (s * s * s) - s / 4;                // b''/b'
+		double h3 = h2 * h2 - 3 * x * x / (s * s * s * s) - 0.25;  // b'''/b'
+		double nu;
+		if (lower && b > 0)
+		{
+			double lambda = vega / b;
+			nu = -log(b / beta) / lambda;
+			h3 = h3 - 3 * h2 * lambda + 2 * lambda * lambda;
+			h2 = h2 - lambda;
+		}
+		else
+			nu = (beta - b) / vega;
+		double ds = nu * (1 + 0.5 * h2 * nu) / (1 + nu * (h2 + h3 * nu / 6));
+		if (!isfinite(ds) || fabs(ds) > fabs(2 * nu) || ds * nu <= 0)
+			ds = nu;//Householder step gone wild: plain Newton
+		double next = s + ds;
+		if (!(next > 0))
+			next = s / 2;
+		if (!isfinite(next))
+			next = 2 * s;
+		result.iterations = i + 1;
+		double step = fabs(next - s);
+		bool done = step <= 16 * DBL_EPSILON * next || b == beta
+			|| (step <= 1e-12 * next && step >= lastStep / 2);
+		lastStep = step;
+		s = next;
+		if (done)
+		{
+			result.vol = s / sqrt(t);
+			return result;
+		}
+	}
+	result.vol = s / sqrt(t);
+	result.status = IV_NO_CONVERGENCE;
+	return result;
+}
+
+double ImpliedVol(double C, double f, double k, double r, double t)//(b)
+{
+	IVResult result = Black76ImpliedVol(C, f, k, r, t, 'C');
+	return result.status == IV_OK ? result.vol : numeric_limits<double>::quiet_NaN();
+}
+
+/* ---------------- batch solves ----------------- */
+
+void IVTelemetry::reset()
+{
+	d_count = 0;
+	d_totalNs = 0;
+	d_maxNs = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; ++i)
+		d_latency[i] = 0;
+	for (int i = 0; i <= IV_MAX_ITERATIONS; ++i)
+	{
+		d_iterations[i] = 0;
+		d_iterationNs[i] = 0;
+	}
+	for (int i = 0; i <= IV_NO_CONVERGENCE; ++i)
+		d_statuses[i] = 0;
+}
+
+// 0..7 ns get a bucket each; above that an octave [2^e, 2^(e+1))
+// is cut into four
+int IVTelemetry::bucket(long long ns)
+{
+	if (ns < 8)
+		return ns < 0 ? 0 : (int)ns;
+	int e = 63 - __builtin_clzll((unsigned long long)ns);
+	int b = 4 * (e - 1) + (int)((ns >> (e - 2)) & 3);
+	return b < LATENCY_BUCKETS ? b : LATENCY_BUCKETS - 1;
+}
+
+long long IVTelemetry::bucket_floor(int bucket)
+{
+	if (bucket < 8)
+		return bucket;
+	return (4LL + bucket % 4) << (bucket / 4 - 1);
+}
+
+void IVTelemetry::record(IVStatus status, int iterations, long long ns)
+{
+	++d_count;
+	d_totalNs += ns;
+	if (ns > d_maxNs)
+		d_maxNs = ns;
+	++d_latency[bucket(ns)];
+	++d_iterations[iterations];
+	d_iterationNs[iterations] += ns;
+	++d_statuses[status];
+}
+
+void IVTelemetry::merge(const IVTelemetry& other)
+{
+	d_count += other.d_count;
+	d_totalNs += other.d_totalNs;
+	if (other.d_maxNs > d_maxNs)
+		d_maxNs = other.d_maxNs;
+	for (int i = 0; i < LATENCY_BUCKETS; ++i)
+		d_latency[i] += other.d_latency[i];
+	for (int i = 0; i <= IV_MAX_ITERATIONS; ++i)
+	{
+		d_iterations[i] += other.d_iterations[i];
+		d_iterationNs[i] += other.d_iterationNs[i];
+	}
+	for (int i = 0; i <= IV_NO_CONVERGENCE; ++i)
+		d_statuses[i] += other.d_statuses[i];
+}
+
+long long IVTelemetry::percentile_ns(double p) const
+{
+	long rank = (long)ceil(p * d_count);
+	long seen = 0;
+	for (int i = 0; i < LATENCY_BUCKETS; ++i)
+	{
+		seen += d_latency[i];
+		if (seen >= rank && seen > 0)
+			return i + 1 < LATENCY_BUCKETS ? bucket_floor(i + 1) : d_maxNs;
+	}
+	return d_maxNs;
+}
+
+void IVTelemetry::put(ostream& out) const
+{
+	static const char* statuses[] = { "ok", "below_intrinsic", "above_maximum", "bad_input", "no_convergence" };
+	out << "solves " << d_count << ", mean " << mean_ns() << " ns, p50 <" << percentile_ns(0.5)
+		<< " ns, p99 <" << percentile_ns(0.99) << " ns, p99.9 <" << percentile_ns(0.999)
+		<< " ns, max " << d_maxNs << " ns\n";
+	out << "status:";
+	for (int i = 0; i <= IV_NO_CONVERGENCE; ++i)
+		if (d_statuses[i])
+			out << " " << statuses[i] << " " << d_statuses[i];
+	out << "\niterations  solves  mean ns\n";
+	for (int i = 0; i <= IV_MAX_ITERATIONS; ++i)
+		if (d_iterations[i])
+			out << i << "  " << d_iterations[i] << "  " << mean_ns_at(i) << "\n";
+	out << "latency ns  solves\n";
+	for (int i = 0; i < LATENCY_BUCKETS; ++i)
+		if (d_latency[i])
+			out << bucket_floor(i) << "-" << bucket_floor(i + 1) << "  " << d_latency[i] << "\n";
+}
+
+static void SolveOne(size_t i, const IVBatchInput& in, const IVBatchOutput& out, IVResult& result)
+{
+	result = Black76ImpliedVol(in.price[i], in.forward[i], in.strike[i], in.rate[i], in.expiry[i],
+		in.type ? in.type[i] : 'C');
+	out.vol[i] = result.status == IV_OK ? result.vol : numeric_limits<double>::quiet_NaN();
+	out.status[i] = result.status;
+	if (out.iterations)
+		out.iterations[i] = result.iterations;
+}
+
+void ImpliedVolBatch(size_t n, const IVBatchInput& in, const IVBatchOutput& out, IVTelemetry* telemetry)
+{
+	IVResult result;
+	if (!telemetry)
+	{
+		for (size_t i = 0; i < n; ++i)
+			SolveOne(i, in, out, result);
+		return;
+	}
+	// one clock read per solve: each one's end is the next one's start
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for (size_t i = 0; i < n; ++i)
+	{
+		SolveOne(i, in, out, result);
+		chrono::steady_clock::time_point end = chrono::steady_clock::now();
+		telemetry->record(result.status, result.iterations,
+			chrono::duration_cast<chrono::nanoseconds>(end - start).count());
+		start = end;
+	}
+}
@@ -0,0 +1,102 @@
+// File: ImpliedVol.h
+// Author(s): Jingyi Guo
+
+#include <cstddef>
+#include <ostream>
+using namespace std;
+#ifndef _IMPLIED_VOL_
+#define _IMPLIED_VOL_
+
+// Why an implied vol could (not) be found
+enum IVStatus {
+    IV_OK,
+    IV_BELOW_INTRINSIC,   // price is less than the discounted intrinsic value
+    IV_ABOVE_MAXIMUM,     // price is at least the discounted forward (or strike, for a put)
+    IV_BAD_INPUT,         // f, k or t not positive, or price not a number
+    IV_NO_CONVERGENCE     // iteration cap reached (vol is the last iterate)
+};
+
+struct IVResult {
+    double vol;           // NaN unless status is IV_OK or IV_NO_CONVERGENCE
+    IVStatus status;
+    int iterations;       // Householder steps taken, at most IV_MAX_ITERATIONS
+};
+
+const int IV_MAX_ITERATIONS = 8;
+
+// Black-76 implied vol of a call (cp 'C') or put (cp 'P') price.
+// A rational initial guess (Jaeckel, "By Implication") is refined
+// by third order Householder steps on the normalised price, in
+// log space below the inflection point.  Ordinary quotes reach full
+// double precision in three to five steps, plus one price evaluation
+// at the inflection point; none ever takes more than
+// IV_MAX_ITERATIONS.
+IVResult Black76ImpliedVol(double price, double f, double k, double r, double t, char cp = 'C');
+
+// call price -> implied vol, NaN if there is none
+double ImpliedVol(double C, double f, double k, double r, double t);
+
+/* ---------------- batch solves ----------------- */
+
+// Where time goes in batch solves.  Latencies are kept in buckets
+// four to an octave (so a percentile is good to within 19%), next to
+// how many solves took each number of iterations and ended in each
+// status.  Fixed size: recording never allocates.
+class IVTelemetry {
+public:
+    enum { LATENCY_BUCKETS = 160 };      // up to 2^40 ns
+
+    IVTelemetry() { reset(); }
+    void reset();
+    void record(IVStatus status, int iterations, long long ns);
+    void merge(const IVTelemetry& other);
+
+    long count() const { return d_count; }
+    double mean_ns() const { return d_count ? (double)d_totalNs / d_count : 0; }
+    long long max_ns() const { return d_maxNs; }
+    // upper edge of the bucket holding the p'th quantile, p in (0, 1]
+    long long percentile_ns(double p) const;
+    long status_count(IVStatus status) const { return d_statuses[status]; }
+    long iteration_count(int iterations) const { return d_iterations[iterations]; }
+    double mean_ns_at(int iterations) const   // of solves taking that many steps
+    {
+        return d_iterations[iterations] ? (double)d_iterationNs[iterations] / d_iterations[iterations] : 0;
+    }
+
+    // summary, percentiles and both histograms, as text
+    void put(ostream& out) const;
+
+    static int bucket(long long ns);
+    static long long bucket_floor(int bucket);
+private:
+    long d_count;
+    long long d_totalNs;
+    long long d_maxNs;
+    long d_latency[LATENCY_BUCKETS];
+    long d_iterations[IV_MAX_ITERATIONS + 1];
+    long long d_iterationNs[IV_MAX_ITERATIONS + 1];
+    long d_statuses[IV_NO_CONVERGENCE + 1];
+};
+
+// A batch of quotes as parallel arrays (structure of arrays)
+struct IVBatchInput {
+    const double* price;
+    const double* forward;
+    const double* strike;
+    const double* rate;
+    const double* expiry;     // years
+    const char* type;         // 'C' or 'P'; 0 for all calls
+};
+
+struct IVBatchOutput {
+    double* vol;              // NaN unless status is IV_OK
+    IVStatus* status;
+    int* iterations;          // may be 0
+};
+
+// Black76ImpliedVol on each of n quotes: no allocation and no
+// indirect calls in the loop.  With telemetry, every solve is timed
+// on its own (about 20 ns extra each) and recorded.
+void ImpliedVolBatch(size_t n, const IVBatchInput& in, const IVBatchOutput& out,
+                     IVTelemetry* telemetry = 0);
+#endif
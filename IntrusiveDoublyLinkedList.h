@@ -0,0 +1,126 @@
+// File: IntrusiveDoublyLinkedList.h
+// Author(s): Jingyi Guo
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+using namespace std;
+#ifndef _INTRUSIVE_DBL_LINK_LIST_
+#define _INTRUSIVE_DBL_LINK_LIST_
+
+// The links of a node, for an object to carry itself: derive from
+// DllHook<> to go on an IntrusiveDoublyLinkedList, or from a
+// DllHook<Tag> per list to be on several at once, e.g.
+//     struct Order : DllHook<ByPrice>, DllHook<ByAccount> { ... };
+template <class Tag = void>
+struct DllHook {
+    DllHook *next;
+    DllHook *prev;
+
+    DllHook() : next(0), prev(0) { }
+    DllHook(const DllHook &) : next(0), prev(0) { }  // a copy is on no list
+    DllHook &operator=(const DllHook &) { return *this; }
+    bool is_linked() const { return next != 0; }
+};
+
+// A doubly linked list of objects that hold their own links, so
+// nothing is allocated or freed: push, insert and erase only relink
+// the objects, O(1), and erase needs only the object itself.  The
+// list never owns its objects; each must stay put, and outlive its
+// time on the list.  An object is on at most one list per hook.
+// The ring runs through a hook in the list itself, which marks the
+// end, so the list cannot be copied or moved.
+template <class T, class Tag = void>
+class IntrusiveDoublyLinkedList {
+public:
+    typedef DllHook<Tag> Hook;
+    template <bool Const> class Iterator;
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+
+    IntrusiveDoublyLinkedList() : d_size(0) { d_end.next = d_end.prev = &d_end; }
+    ~IntrusiveDoublyLinkedList() { clear(); }
+
+    void push_back(T &obj) { link(&d_end, &obj); }
+    void push_front(T &obj) { link(d_end.next, &obj); }
+    void pop_back() { if (d_size) unlink(d_end.prev); }
+    void pop_front() { if (d_size) unlink(d_end.next); }
+    void insert_before(T &pos, T &obj) { link(hook(&pos), &obj); }
+    void insert_after(T &pos, T &obj) { link(hook(&pos)->next, &obj); }
+    void erase(T &obj) { unlink(hook(&obj)); }
+    void clear()               // unlinks every object, O(n)
+    {
+        while (d_size)
+            unlink(d_end.next);
+    }
+    T &front() { return *object(d_end.next); }  // the list must not
+    T &back() { return *object(d_end.prev); }   // be empty
+    const T &front() const { return *object(d_end.next); }
+    const T &back() const { return *object(d_end.prev); }
+
+    iterator begin() { return iterator(d_end.next); }
+    iterator end() { return iterator(&d_end); }
+    const_iterator begin() const { return const_iterator(d_end.next); }
+    const_iterator end() const { return const_iterator(const_cast<Hook *>(&d_end)); }
+    iterator iterator_to(T &obj) { return iterator(hook(&obj)); }
+
+    bool empty() const { return d_size == 0; }
+    int size() const { return d_size; }
+private:
+    IntrusiveDoublyLinkedList(const IntrusiveDoublyLinkedList &);
+    IntrusiveDoublyLinkedList &operator=(const IntrusiveDoublyLinkedList &);
+
+    static Hook *hook(T *obj) { return static_cast<Hook *>(obj); }
+    static T *object(Hook *h) { return static_cast<T *>(h); }
+    static const T *object(const Hook *h) { return static_cast<const T *>(h); }
+
+    void link(Hook *pos, T *obj)  // in front of pos
+    {
+        Hook *h = hook(obj);
+        h->prev = pos->prev;
+        h->next = pos;
+        pos->prev->next = h;
+        pos->prev = h;
+        ++d_size;
+    }
+
+    void unlink(Hook *h)
+    {
+        h->prev->next = h->next;
+        h->next->prev = h->prev;
+        h->next = h->prev = 0;
+        --d_size;
+    }
+
+    Hook d_end;                // before the first, after the last
+    int d_size;
+};
+
+template <class T, class Tag>
+template <bool Const>
+class IntrusiveDoublyLinkedList<T, Tag>::Iterator {
+public:
+    typedef bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef ptrdiff_t difference_type;
+    typedef typename conditional<Const, const T *, T *>::type pointer;
+    typedef typename conditional<Const, const T &, T &>::type reference;
+
+    Iterator() : d_hook(0) { }
+    Iterator(const Iterator<false> &other) : d_hook(other.d_hook) { }
+    reference operator*() const { return *object(d_hook); }
+    pointer operator->() const { return object(d_hook); }
+    Iterator &operator++() { d_hook = d_hook->next; return *this; }
+    Iterator operator++(int) { Iterator was(*this); ++*this; return was; }
+    Iterator &operator--() { d_hook = d_hook->prev; return *this; }
+    Iterator operator--(int) { Iterator was(*this); --*this; return was; }
+    bool operator==(const Iterator &other) const { return d_hook == other.d_hook; }
+    bool operator!=(const Iterator &other) const { return d_hook != other.d_hook; }
+private:
+    friend class IntrusiveDoublyLinkedList;
+    friend class Iterator<!Const>;
+    explicit Iterator(Hook *h) : d_hook(h) { }
+
+    Hook *d_hook;
+};
+#endif
@@ -0,0 +1,474 @@
+// File: ListBench.cpp
+// Author(s): Jingyi Guo
+//
+// Usage:  listbench [max_size [container]]
+//   Times DoublyLinkedList (from the heap, from a pool, and with
+//   min/max tracking), UnrolledDoublyLinkedList, std::list and
+//   std::deque on each workload below, at sizes 10, 100, ... up to
+//   max_size (default 10000000).  Prints one CSV line per case:
+//   ns and heap allocations per operation, and the peak resident
+//   set of the process that ran it, in kB.  Each case runs in a
+//   process of its own, so peaks do not carry over from one to the
+//   next.  Small sizes are repeated until a case has done about a
+//   million operations.
+//     push_back, push_front   build a list of size values
+//     pop_back, pop_front     empty a list of size values
+//     traverse                read every value, with an iterator
+//     copy, assign            copy construct, or assign over a list of
+//                             the same size; an op is one value
+//     aggregate               sum, min, max and mean; an op is one query
+//     churn                   random pushes and pops at both ends, as
+//                             many as size, starting from and staying
+//                             around size values
+//   UnrolledDoublyLinkedList has no iterators, so no traverse.
+//   First it checks that DoublyLinkedList handles still insert and
+//   erase in the right place after their list is moved or spliced,
+//   and stops if they do not.
+//
+// Build:  g++ -std=c++17 -O2 ListBench.cpp DoublyLinkedList.cpp UnrolledDoublyLinkedList.cpp -o listbench
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <list>
+#include <deque>
+#include <new>
+#include <cstdlib>
+#include <chrono>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace std;
+#include "DoublyLinkedList.h"
+#include "UnrolledDoublyLinkedList.h"
+
+/* ---------------- counting allocations ----------------- */
+
+static unsigned long long g_allocs = 0;
+
+void* operator new(size_t n)
+{
+	++g_allocs;
+	if (void* p = malloc(n ? n : 1))
+		return p;
+	throw bad_alloc();
+}
+
+void* operator new[](size_t n)
+{
+	return operator new(n);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	free(p);
+}
+
+// time and allocations between start() and stop(), added up
+struct Meter {
+	double ns;
+	unsigned long long allocs;
+	unsigned long long ops;
+	chrono::steady_clock::time_point t0;
+	unsigned long long a0;
+
+	Meter() : ns(0), allocs(0), ops(0) { }
+	void start()
+	{
+		a0 = g_allocs;
+		t0 = chrono::steady_clock::now();
+	}
+	void stop(unsigned long long n)
+	{
+		ns += chrono::duration<double, nano>(chrono::steady_clock::now() - t0).count();
+		allocs += g_allocs - a0;
+		ops += n;
+	}
+};
+
+/* ---------------- the containers ----------------- */
+
+struct HeapList {
+	typedef DoublyLinkedList List;
+	List make() { return List(); }
+};
+
+struct PooledList {
+	typedef DoublyLinkedList List;
+	DllNodePool pool;
+	List make() { return List(pool); }
+};
+
+struct TrackedList {
+	typedef DoublyLinkedList List;
+	List make()
+	{
+		List list;
+		list.track_min_max();
+		return list;
+	}
+};
+
+struct Unrolled {
+	typedef UnrolledDoublyLinkedList List;
+	List make() { return List(); }
+};
+
+struct StdList {
+	typedef list<int> List;
+	List make() { return List(); }
+};
+
+struct StdDeque {
+	typedef deque<int> List;
+	List make() { return List(); }
+};
+
+// the lists keep their own aggregates; the std containers are walked
+long long Sum(const DoublyLinkedList& l) { return l.sum(); }
+int Min(const DoublyLinkedList& l) { return l.min(); }
+int Max(const DoublyLinkedList& l) { return l.max(); }
+double Mean(const DoublyLinkedList& l) { return l.mean(); }
+long long Sum(const UnrolledDoublyLinkedList& l) { return l.sum(); }
+int Min(const UnrolledDoublyLinkedList& l) { return l.min(); }
+int Max(const UnrolledDoublyLinkedList& l) { return l.max(); }
+double Mean(const UnrolledDoublyLinkedList& l) { return l.mean(); }
+
+template <class C>
+long long Sum(const C& c)
+{
+	long long sum = 0;
+	for (typename C::const_iterator i = c.begin(); i != c.end(); ++i)
+		sum += *i;
+	return sum;
+}
+
+template <class C>
+int Min(const C& c)
+{
+	int min = c.front();
+	for (typename C::const_iterator i = c.begin(); i != c.end(); ++i)
+		min = *i < min ? *i : min;
+	return min;
+}
+
+template <class C>
+int Max(const C& c)
+{
+	int max = c.front();
+	for (typename C::const_iterator i = c.begin(); i != c.end(); ++i)
+		max = *i > max ? *i : max;
+	return max;
+}
+
+template <class C>
+double Mean(const C& c)
+{
+	return Sum(c) / (double)c.size();
+}
+
+/* ---------------- the workloads ----------------- */
+
+static volatile long long g_sink;  // so results are not optimised away
+
+// xorshift: the same numbers for every container
+struct Random {
+	unsigned long long x;
+	Random() : x(88172645463325252ULL) { }
+	unsigned next()
+	{
+		x ^= x << 13;
+		x ^= x >> 7;
+		x ^= x << 17;
+		return (unsigned)x;
+	}
+};
+
+template <class Maker>
+typename Maker::List Filled(Maker& maker, size_t n)
+{
+	typename Maker::List list = maker.make();
+	for (size_t i = 0; i < n; ++i)
+		list.push_back((int)i);
+	return list;
+}
+
+template <class Maker>
+void PushBack(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	for (size_t r = 0; r < reps; ++r)
+	{
+		typename Maker::List list = maker.make();
+		meter.start();
+		for (size_t i = 0; i < n; ++i)
+			list.push_back((int)i);
+		meter.stop(n);
+	}
+}
+
+template <class Maker>
+void PushFront(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	for (size_t r = 0; r < reps; ++r)
+	{
+		typename Maker::List list = maker.make();
+		meter.start();
+		for (size_t i = 0; i < n; ++i)
+			list.push_front((int)i);
+		meter.stop(n);
+	}
+}
+
+template <class Maker>
+void PopBack(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	for (size_t r = 0; r < reps; ++r)
+	{
+		typename Maker::List list = Filled(maker, n);
+		meter.start();
+		for (size_t i = 0; i < n; ++i)
+			list.pop_back();
+		meter.stop(n);
+	}
+}
+
+template <class Maker>
+void PopFront(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	for (size_t r = 0; r < reps; ++r)
+	{
+		typename Maker::List list = Filled(maker, n);
+		meter.start();
+		for (size_t i = 0; i < n; ++i)
+			list.pop_front();
+		meter.stop(n);
+	}
+}
+
+template <class Maker>
+void Traverse(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	typename Maker::List list = Filled(maker, n);
+	long long sum = 0;
+	meter.start();
+	for (size_t r = 0; r < reps; ++r)
+		for (typename Maker::List::const_iterator i = list.begin(); i != list.end(); ++i)
+			sum += *i;
+	meter.stop(n * reps);
+	g_sink = sum;
+}
+
+template <>
+void Traverse(Unrolled&, size_t, size_t, Meter&)
+{
+}
+
+template <class Maker>
+void Copy(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	typename Maker::List list = Filled(maker, n);
+	for (size_t r = 0; r < reps; ++r)
+	{
+		meter.start();
+		typename Maker::List copy(list);
+		meter.stop(n);
+		g_sink = copy.size();
+	}
+}
+
+template <class Maker>
+void Assign(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	typename Maker::List list = Filled(maker, n), target = Filled(maker, n);
+	for (size_t r = 0; r < reps; ++r)
+	{
+		meter.start();
+		target = list;
+		meter.stop(n);
+	}
+	g_sink = target.size();
+}
+
+template <class Maker>
+void Aggregate(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	typename Maker::List list = Filled(maker, n);
+	long long sum = 0;
+	double mean = 0;
+	meter.start();
+	for (size_t r = 0; r < reps; ++r)
+	{
+		sum += Sum(list) + Min(list) + Max(list);
+		mean += Mean(list);
+	}
+	meter.stop(4 * reps);
+	g_sink = sum + (long long)mean;
+}
+
+template <class Maker>
+void Churn(Maker& maker, size_t n, size_t reps, Meter& meter)
+{
+	typename Maker::List list = Filled(maker, n);
+	Random random;
+	meter.start();
+	for (size_t i = 0; i < n * reps; ++i)
+	{
+		unsigned r = random.next();
+		bool push = (r & 2) || list.size() == 0;
+		if (push && (r & 1))
+			list.push_front((int)r);
+		else if (push)
+			list.push_back((int)r);
+		else if (r & 1)
+			list.pop_front();
+		else
+			list.pop_back();
+	}
+	meter.stop(n * reps);
+	g_sink = list.size();
+}
+
+/* ---------------- handles ----------------- */
+
+string Contents(const DoublyLinkedList& list)
+{
+	ostringstream os;
+	os << list;
+	return os.str();
+}
+
+bool Expect(const DoublyLinkedList& list, const string& want, const char* what)
+{
+	if (Contents(list) == want)
+		return true;
+	cerr << what << ": got \"" << Contents(list) << "\", want \"" << want << "\"\n";
+	return false;
+}
+
+// a handle to the back, used after its list has moved on, must still
+// insert and erase next to its own node
+bool CheckHandles()
+{
+	bool ok = true;
+	DoublyLinkedList a;
+	a.push_back(1);
+	DoublyLinkedList::iterator back = a.push_back(2);
+	DoublyLinkedList moved(std::move(a));
+	moved.insert_after(back, 3);
+	ok = Expect(moved, "1 2 3", "insert_after a moved handle") && ok;
+	moved.insert_before(back, 4);
+	ok = Expect(moved, "1 4 2 3", "insert_before a moved handle") && ok;
+
+	DoublyLinkedList from, to;
+	from.push_back(1);
+	back = from.push_back(2);
+	to.push_back(0);
+	to.splice(to.end(), from);
+	to.insert_after(back, 3);
+	ok = Expect(to, "0 1 2 3", "insert_after a spliced handle") && ok;
+	DoublyLinkedList::iterator next = to.erase(back);
+	ok = Expect(to, "0 1 3", "erase a spliced handle") && ok;
+	if (next == to.end() || *next != 3)
+	{
+		cerr << "erase a spliced handle: wrong next\n";
+		ok = false;
+	}
+	return ok;
+}
+
+/* ---------------- driver ----------------- */
+
+const char* Workloads[] = {
+	"push_back", "push_front", "pop_back", "pop_front",
+	"traverse", "copy", "assign", "aggregate", "churn"
+};
+const size_t WorkloadCount = sizeof(Workloads) / sizeof(Workloads[0]);
+
+const char* Containers[] = {
+	"dll", "dll_pool", "dll_minmax", "unrolled", "std_list", "std_deque"
+};
+const size_t ContainerCount = sizeof(Containers) / sizeof(Containers[0]);
+
+template <class Maker>
+void Run(size_t workload, size_t n, Meter& meter)
+{
+	size_t reps = n >= 1000000 ? 1 : 1000000 / n;
+	Maker maker;
+	void (*const work[])(Maker&, size_t, size_t, Meter&) = {
+		PushBack<Maker>, PushFront<Maker>, PopBack<Maker>, PopFront<Maker>,
+		Traverse<Maker>, Copy<Maker>, Assign<Maker>, Aggregate<Maker>, Churn<Maker>
+	};
+	work[workload](maker, n, reps, meter);
+}
+
+// runs one case in a child process, which prints its line
+void RunCase(size_t container, size_t workload, size_t n)
+{
+	cout.flush();
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		cerr << "cannot fork\n";
+		exit(1);
+	}
+	if (pid > 0)
+	{
+		int status;
+		waitpid(pid, &status, 0);
+		if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+			cerr << Containers[container] << "," << Workloads[workload] << "," << n << " failed\n";
+		return;
+	}
+	Meter meter;
+	switch (container)
+	{
+	case 0: Run<HeapList>(workload, n, meter); break;
+	case 1: Run<PooledList>(workload, n, meter); break;
+	case 2: Run<TrackedList>(workload, n, meter); break;
+	case 3: Run<Unrolled>(workload, n, meter); break;
+	case 4: Run<StdList>(workload, n, meter); break;
+	case 5: Run<StdDeque>(workload, n, meter); break;
+	}
+	if (meter.ops == 0)  // not a workload this container has
+		_exit(0);
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	cout << Containers[container] << "," << Workloads[workload] << "," << n << "," << meter.ops << ","
+		<< meter.ns / meter.ops << "," << (double)meter.allocs / meter.ops << "," << usage.ru_maxrss << "\n";
+	cout.flush();
+	_exit(0);
+}
+
+int main(int argc, char* argv[])
+{
+	size_t maxSize = argc > 1 ? strtoull(argv[1], 0, 10) : 10000000;
+	string only = argc > 2 ? argv[2] : "";
+	if (!CheckHandles())
+		return 1;
+
+	cout << "container,workload,size,ops,ns_per_op,allocs_per_op,peak_rss_kb\n";
+	for (size_t c = 0; c < ContainerCount; ++c)
+	{
+		if (!only.empty() && only != Containers[c])
+			continue;
+		for (size_t w = 0; w < WorkloadCount; ++w)
+			for (size_t n = 10; n <= maxSize; n *= 10)
+				RunCase(c, w, n);
+	}
+	return 0;
+}
@@ -0,0 +1,135 @@
+// File: OptionMath.h
+// Author(s): Jingyi Guo
+//
+// The pricing formulas are templates so that they run on Dual and
+// HyperDual numbers as well as doubles; the *Greeks functions use
+// that to get every sensitivity out of a single evaluation.  Each has
+// a plain double overload as well, which takes any arithmetic
+// arguments, so calls such as Black76CallPrice(48.33, 50, 0.01, t, v)
+// work as they did before the templates.
+
+#include <cmath>
+#include <type_traits>
+using namespace std;
+#include "Dual.h"
+#ifndef _OPTION_MATH_
+#define _OPTION_MATH_
+
+// T, for the types the templates are for: double and the Dual numbers;
+// no type for ints and floats, which go to the double overloads
+template <class T>
+struct PricingType : enable_if<!is_arithmetic<T>::value || is_same<T, double>::value, T> { };
+
+// define the NormCDF function here
+template <class T>
+inline typename PricingType<T>::type NormCDF(const T& x)
+{
+	return (1 / 2.0 + 1 / 2.0 * erf(x / sqrt(2.0)));
+}
+
+inline double NormCDF(double x)
+{
+	return NormCDF<double>(x);
+}
+
+template <class T>
+inline typename PricingType<T>::type BSMEuroCallPrice(const T& s0, const T& k, const T& r, const T& t, const T& sigma)
+{
+	T d1 = (log(s0 / k) + (r + pow(sigma, 2.0) / 2.0)*t) / (sigma*sqrt(t));
+	T d2 = d1 - sigma*sqrt(t);
+	return (s0*NormCDF(d1) - exp(-r*t)*k*NormCDF(d2));
+}
+
+inline double BSMEuroCallPrice(double s0, double k, double r, double t, double sigma)
+{
+	return BSMEuroCallPrice<double>(s0, k, r, t, sigma);
+}
+
+template <class T>
+inline typename PricingType<T>::type Black76CallPrice(const T& f, const T& k, const T& r, const T& t, const T& sigma)
+{
+	T d1 = (log(f / k) + (pow(sigma, 2.0) / 2.0)*t) / (sigma*sqrt(t));
+	T d2 = d1 - sigma*sqrt(t);
+	return (exp(-r*t)*(f*NormCDF(d1) - k*NormCDF(d2)));
+}
+
+inline double Black76CallPrice(double f, double k, double r, double t, double sigma)
+{
+	return Black76CallPrice<double>(f, k, r, t, sigma);
+}
+
+template <class T>
+inline typename PricingType<T>::type Black76PutPrice(const T& f, const T& k, const T& r, const T& t, const T& sigma)
+{
+	T d1 = (log(f / k) + (pow(sigma, 2.0) / 2.0)*t) / (sigma*sqrt(t));
+	T d2 = d1 - sigma*sqrt(t);
+	return (exp(-r*t)*(k*NormCDF(-d2) - f*NormCDF(-d1)));
+}
+
+inline double Black76PutPrice(double f, double k, double r, double t, double sigma)
+{
+	return Black76PutPrice<double>(f, k, r, t, sigma);
+}
+
+// dPrice/dsigma, the same for calls and puts
+template <class T>
+inline typename PricingType<T>::type Black76Vega(const T& f, const T& k, const T& r, const T& t, const T& sigma)
+{
+	T d1 = (log(f / k) + (pow(sigma, 2.0) / 2.0)*t) / (sigma*sqrt(t));
+	return exp(-r*t)*f*sqrt(t)*exp(-d1*d1 / 2.0) / sqrt(2.0*M_PI);
+}
+
+inline double Black76Vega(double f, double k, double r, double t, double sigma)
+{
+	return Black76Vega<double>(f, k, r, t, sigma);
+}
+
+/* ---------------- Greeks ----------------- */
+
+struct Greeks {
+	double price;
+	double delta;    // d/dS (the forward, for Black-76)
+	double gamma;    // d2/dS2
+	double vega;     // d/dsigma
+	double theta;    // -d/dt: value lost per year as expiry nears
+	double rho;      // d/dr
+	double vanna;    // d2/dS dsigma
+	double volga;    // d2/dsigma2
+};
+
+// the inputs' indexes in a GreeksDual
+enum GreeksInput { GREEKS_S, GREEKS_SIGMA, GREEKS_T, GREEKS_R };
+typedef HyperDual<4> GreeksDual;
+
+inline Greeks GreeksOf(const GreeksDual& price)
+{
+	Greeks g;
+	g.price = price.v;
+	g.delta = price.d[GREEKS_S];
+	g.gamma = price.h[GREEKS_S][GREEKS_S];
+	g.vega = price.d[GREEKS_SIGMA];
+	g.theta = -price.d[GREEKS_T];
+	g.rho = price.d[GREEKS_R];
+	g.vanna = price.h[GREEKS_S][GREEKS_SIGMA];
+	g.volga = price.h[GREEKS_SIGMA][GREEKS_SIGMA];
+	return g;
+}
+
+inline Greeks BSMEuroCallGreeks(double s0, double k, double r, double t, double sigma)
+{
+	return GreeksOf(BSMEuroCallPrice(GreeksDual(s0, GREEKS_S), GreeksDual(k), GreeksDual(r, GREEKS_R),
+		GreeksDual(t, GREEKS_T), GreeksDual(sigma, GREEKS_SIGMA)));
+}
+
+inline Greeks Black76CallGreeks(double f, double k, double r, double t, double sigma)
+{
+	return GreeksOf(Black76CallPrice(GreeksDual(f, GREEKS_S), GreeksDual(k), GreeksDual(r, GREEKS_R),
+		GreeksDual(t, GREEKS_T), GreeksDual(sigma, GREEKS_SIGMA)));
+}
+
+inline Greeks Black76PutGreeks(double f, double k, double r, double t, double sigma)
+{
+	return GreeksOf(Black76PutPrice(GreeksDual(f, GREEKS_S), GreeksDual(k), GreeksDual(r, GREEKS_R),
+		GreeksDual(t, GREEKS_T), GreeksDual(sigma, GREEKS_SIGMA)));
+}
+#endif
@@ -0,0 +1,203 @@
+// File: Pa2Bench.cpp
+// Author(s): Jingyi Guo
+//
+// Usage:  pa2bench [megabytes [repetitions [seed]]]
+//   Generates a synthetic pa2 file (and a gzip'd copy of it), then
+//   times each way hw1.1 can read it and each output format.  Prints
+//   one CSV line per case; the best of the repetitions is reported.
+//   First it checks that the report reads back as the records it was
+//   written from, and stops if it does not.
+//
+// Build:  g++ -std=c++17 -O2 Pa2Bench.cpp Pa2Generator.cpp SpanParser.cpp Pa2Output.cpp GzReader.cpp -lz -pthread -o pa2bench
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <zlib.h>
+using namespace std;
+#include "SpanParser.h"
+#include "Pa2Output.h"
+#include "Pa2Generator.h"
+#include "GzReader.h"
+
+// parse only: the records go nowhere
+class NullSink : public Pa2RecordSink {
+public:
+	void put(const Pa2Record&) { }
+};
+
+// line by line with getline, as hw1.1 reads stdin
+long ReadLines(const string& fileName, Pa2RecordSink& sink)
+{
+	ifstream fin(fileName.c_str(), ios::binary);
+	Pa2StreamParser parser(sink);
+	string line;
+	while (getline(fin, line))
+	{
+		line += '\n';
+		parser.feed(line.data(), line.size());
+	}
+	parser.finish();
+	return parser.records();
+}
+
+// 1 MB blocks, as hw1.1 reads a whole file
+long ReadChunks(const string& fileName, Pa2RecordSink& sink)
+{
+	ifstream fin(fileName.c_str(), ios::binary);
+	Pa2StreamParser parser(sink);
+	vector<char> buf(1 << 20);
+	while (fin.read(&buf[0], buf.size()) || fin.gcount() > 0)
+		parser.feed(&buf[0], fin.gcount());
+	parser.finish();
+	return parser.records();
+}
+
+// decompressing in a second thread, as hw1.1 reads a .gz file
+long ReadGzip(const string& fileName, Pa2RecordSink& sink)
+{
+	GzChunkReader reader(vector<string>(1, fileName));
+	GzChunkReader::Chunk chunk;
+	Pa2StreamParser parser(sink);
+	while (reader.next(chunk))
+		parser.feed(chunk.data, chunk.size);
+	parser.finish();
+	return parser.records();
+}
+
+// keeps every record it is given
+class CollectSink : public Pa2RecordSink {
+public:
+	vector<Pa2Record> records;
+	void put(const Pa2Record& rec) { records.push_back(rec); }
+};
+
+// all a report shows: the options code only on option expiry lines
+bool SameRecord(const Pa2Record& a, const Pa2Record& b)
+{
+	bool codes = a.kind != PA2_OPT_EXPIRY || (a.optCode[0] == b.optCode[0] && a.optCode[1] == b.optCode[1]);
+	return a.kind == b.kind && a.product[0] == b.product[0] && a.product[1] == b.product[1] && codes && a.type == b.type
+		&& a.contractMonth == b.contractMonth && a.expDate == b.expDate
+		&& a.strikeTicks == b.strikeTicks && a.settleTicks == b.settleTicks && a.decimals == b.decimals;
+}
+
+// the report written by ReportSink has to read back, through
+// ReadPa2Report, as the very records it was written from
+bool CheckReportRoundTrip(const string& plain, const string& report)
+{
+	CollectSink written, read;
+	ReadChunks(plain, written);
+	{
+		OutBuffer out(report);
+		ReportSink sink(out);
+		for (size_t i = 0; i < written.records.size(); ++i)
+			sink.put(written.records[i]);
+	}
+	ReadPa2Report(report, read);
+	remove(report.c_str());
+	if (read.records.size() != written.records.size())
+	{
+		cerr << "report round trip: wrote " << written.records.size() << " records, read "
+			<< read.records.size() << "\n";
+		return false;
+	}
+	for (size_t i = 0; i < written.records.size(); ++i)
+		if (!SameRecord(written.records[i], read.records[i]))
+		{
+			cerr << "report round trip: record " << i << " reads back differently\n";
+			return false;
+		}
+	return true;
+}
+
+bool Compress(const string& from, const string& to)
+{
+	ifstream fin(from.c_str(), ios::binary);
+	gzFile gz = gzopen(to.c_str(), "wb6");
+	if (!fin || !gz)
+		return false;
+	vector<char> buf(1 << 20);
+	while (fin.read(&buf[0], buf.size()) || fin.gcount() > 0)
+		gzwrite(gz, &buf[0], (unsigned)fin.gcount());
+	gzclose(gz);
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	Pa2GenConfig config;
+	config.megabytes = argc > 1 ? atof(argv[1]) : 200;
+	int reps = argc > 2 ? atoi(argv[2]) : 3;
+	config.seed = argc > 3 ? strtoull(argv[3], 0, 10) : 20160826;
+	config.clWeight = 4;
+	config.ngWeight = 2;
+	config.otherWeight = 4;
+
+	string plain = "pa2bench.pa2";
+	string packed = "pa2bench.pa2.gz";
+	unsigned long long bytes;
+	{
+		OutBuffer out(plain);
+		if (!out.ok())
+		{
+			cerr << "cannot write " << plain << "\n";
+			return 1;
+		}
+		bytes = GeneratePa2(out, config);
+	}
+	if (!Compress(plain, packed))
+	{
+		cerr << "cannot write " << packed << "\n";
+		return 1;
+	}
+	if (!CheckReportRoundTrip(plain, "pa2bench.txt"))
+		return 1;
+
+	struct Case {
+		const char* mode;
+		const char* sink;
+		long (*read)(const string&, Pa2RecordSink&);
+		const string* file;
+	};
+	const Case cases[] = {
+		{ "getline", "null", ReadLines, &plain },
+		{ "chunk", "null", ReadChunks, &plain },
+		{ "gzip", "null", ReadGzip, &packed },
+		{ "chunk", "report", ReadChunks, &plain },
+		{ "chunk", "csv", ReadChunks, &plain },
+		{ "chunk", "bin", ReadChunks, &plain },
+	};
+	cout << "mode,sink,input_mb,records,seconds,mb_per_s,records_per_s\n";
+	for (size_t c = 0; c < sizeof(cases) / sizeof(cases[0]); ++c)
+	{
+		double best = 1e300;
+		long records = 0;
+		for (int r = 0; r < reps; ++r)
+		{
+			string sinkName = cases[c].sink;
+			OutBuffer out("/dev/null");
+			NullSink none;
+			Pa2RecordSink* sink = sinkName == "report" ? (Pa2RecordSink*)new ReportSink(out)
+				: sinkName == "csv" ? (Pa2RecordSink*)new CsvSink(out)
+				: sinkName == "bin" ? (Pa2RecordSink*)new BinarySink(out)
+				: 0;
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			records = cases[c].read(*cases[c].file, sink ? *sink : none);
+			out.flush();
+			double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+			delete sink;
+			if (seconds < best)
+				best = seconds;
+		}
+		double mb = bytes / 1e6;
+		cout << cases[c].mode << "," << cases[c].sink << "," << mb << "," << records << ","
+			<< best << "," << mb / best << "," << records / best << "\n";
+	}
+	remove(plain.c_str());
+	remove(packed.c_str());
+	return 0;
+}
@@ -0,0 +1,45 @@
+// File: Pa2Gen.cpp
+// Author(s): Jingyi Guo
+//
+// Usage:  pa2gen output megabytes [seed [cl:ng:other]]
+//   Writes a synthetic pa2 file of about the given size (- for stdout).
+//   The same seed and mix always give the same file; the default mix
+//   is 4:2:4 (four in ten series CL, two NG, four skipped products).
+//
+// Build:  g++ -std=c++17 -O2 Pa2Gen.cpp Pa2Generator.cpp Pa2Output.cpp SpanParser.cpp -o pa2gen
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+using namespace std;
+#include "Pa2Generator.h"
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		cerr << "usage: " << argv[0] << " output megabytes [seed [cl:ng:other]]\n";
+		return 1;
+	}
+	Pa2GenConfig config;
+	config.megabytes = atof(argv[2]);
+	config.seed = argc > 3 ? strtoull(argv[3], 0, 10) : 20160826;
+	config.clWeight = 4;
+	config.ngWeight = 2;
+	config.otherWeight = 4;
+	if (argc > 4 && sscanf(argv[4], "%lf:%lf:%lf", &config.clWeight, &config.ngWeight, &config.otherWeight) != 3)
+	{
+		cerr << "mix must look like 4:2:4\n";
+		return 1;
+	}
+	OutBuffer out(argv[1]);
+	if (!out.ok())
+	{
+		cerr << "cannot write " << argv[1] << "\n";
+		return 1;
+	}
+	unsigned long long bytes = GeneratePa2(out, config);
+	cerr << bytes << " bytes written\n";
+	return 0;
+}
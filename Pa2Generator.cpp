@@ -0,0 +1,208 @@
+// File: Pa2Generator.cpp
+// Author(s): Jingyi Guo
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+using namespace std;
+#include "Pa2Generator.h"
+#include "OptionMath.h"
+
+// xorshift64*: the same numbers from the same seed on every platform
+class Rng {
+public:
+	Rng(unsigned long long seed) : d_state(seed * 0x9E3779B97F4A7C15ULL + 1) { }
+	unsigned long long next()
+	{
+		d_state ^= d_state >> 12;
+		d_state ^= d_state << 25;
+		d_state ^= d_state >> 27;
+		return d_state * 2685821657736338717ULL;
+	}
+	double uniform()   // [0, 1)
+	{
+		return (next() >> 11) * (1.0 / 9007199254740992.0);
+	}
+private:
+	unsigned long long d_state;
+};
+
+// what a product's prices look like, in the units hw1.1 parses them
+struct GenProduct {
+	const char* code;
+	const char* optCode;
+	double priceLo, priceHi;   // futures settlement range
+	double strikeStep;
+	int decimals;
+};
+
+static const GenProduct Products[] = {
+	{ "CL", "LO", 4.00, 6.00, 0.10, 2 },
+	{ "NG", "ON", 2.50, 3.50, 0.05, 3 },
+	{ "HO", "OH", 1.40, 1.80, 0.05, 4 },   // skipped by hw1.1
+	{ "RB", "OB", 1.30, 1.60, 0.05, 4 },   // skipped by hw1.1
+};
+
+static const int FirstMonth = 201609;
+static const int NumMonths = 34;         // through 2019-06
+static const int ValueDate = 20160826;
+static const int LineLength = 132;
+
+static int AddMonths(int yyyymm, int n)
+{
+	int m = yyyymm / 100 * 12 + yyyymm % 100 - 1 + n;
+	return m / 12 * 100 + m % 12 + 1;
+}
+
+// futures expire on the 20th, options on the 17th, of the month
+// before the contract month
+static int FuturesExpiry(int yyyymm) { return AddMonths(yyyymm, -1) * 100 + 20; }
+static int OptionsExpiry(int yyyymm) { return AddMonths(yyyymm, -1) * 100 + 17; }
+
+static double Black76(char cp, double f, double k, double r, double t, double sigma)
+{
+	if (t <= 0)
+		return exp(-r * t) * (cp == 'C' ? fmax(f - k, 0.0) : fmax(k - f, 0.0));
+	return cp == 'C' ? Black76CallPrice(f, k, r, t, sigma) : Black76PutPrice(f, k, r, t, sigma);
+}
+
+// a fixed-width pa2 line being filled in
+class Pa2Line {
+public:
+	Pa2Line() { memset(d_text, ' ', LineLength); }
+	void put(int pos, const char* s) { memcpy(d_text + pos, s, strlen(s)); }
+	void put(int pos, int width, long long value)   // zero padded
+	{
+		for (int i = width - 1; i >= 0; --i)
+		{
+			d_text[pos + i] = '0' + value % 10;
+			value /= 10;
+		}
+	}
+	unsigned long long write(OutBuffer& out) const
+	{
+		out.put(d_text, LineLength);
+		out.put('\n');
+		return LineLength + 1;
+	}
+private:
+	char d_text[LineLength];
+};
+
+static long long Ticks(double price, int decimals, long long most)
+{
+	long long ticks = llround(price * pow(10.0, decimals));
+	return ticks < 0 ? 0 : ticks > most ? most : ticks;
+}
+
+// option settlements round up: to the nearest tick, a deep in the
+// money price could end up below its discounted intrinsic value
+static long long TicksUp(double price, int decimals, long long most)
+{
+	long long ticks = (long long)ceil(price * pow(10.0, decimals) - 1e-9);
+	return ticks < 0 ? 0 : ticks > most ? most : ticks;
+}
+
+unsigned long long GeneratePa2(OutBuffer& out, const Pa2GenConfig& config)
+{
+	Rng rng(config.seed);
+	unsigned long long target = (unsigned long long)(config.megabytes * 1e6);
+	unsigned long long bytes = 0;
+	int numProducts = sizeof(Products) / sizeof(Products[0]);
+
+	// type B: futures and options expiries of every product and month
+	for (int p = 0; p < numProducts; ++p)
+		for (int i = 0; i < NumMonths; ++i)
+		{
+			int month = AddMonths(FirstMonth, i);
+			Pa2Line fut;
+			fut.put(0, "B");
+			fut.put(5, Products[p].code);
+			fut.put(15, "FUT");
+			fut.put(18, 6, month);
+			fut.put(91, 8, FuturesExpiry(month));
+			fut.put(99, Products[p].code);
+			bytes += fut.write(out);
+			Pa2Line opt;
+			opt.put(0, "B");
+			opt.put(5, Products[p].optCode);
+			opt.put(15, "OOF");
+			opt.put(18, 6, month);
+			opt.put(27, 6, month);
+			opt.put(91, 8, OptionsExpiry(month));
+			opt.put(99, Products[p].code);
+			bytes += opt.write(out);
+		}
+
+	// one futures settlement and smile level per product and month,
+	// so that every series of a (product, month) agrees with the others
+	vector<double> forwards(numProducts * NumMonths), levels(numProducts * NumMonths);
+	for (int p = 0; p < numProducts; ++p)
+	{
+		double scale = pow(10.0, Products[p].decimals);
+		for (int i = 0; i < NumMonths; ++i)
+		{
+			double f = Products[p].priceLo + rng.uniform() * (Products[p].priceHi - Products[p].priceLo);
+			forwards[p * NumMonths + i] = floor(f * scale) / scale;
+			levels[p * NumMonths + i] = 0.25 + 0.2 * rng.uniform();
+		}
+	}
+
+	// type 8: series of a futures settlement and its option chain.  The
+	// mix picks the product; each product goes through its months in
+	// order, once per cycle, and starts over (the same series again)
+	// until the size is reached.
+	double total = config.clWeight + config.ngWeight + config.otherWeight;
+	if (total <= 0)
+		total = 1;
+	vector<int> nextMonth(numProducts, 0);
+	while (bytes < target)
+	{
+		double u = rng.uniform() * total;
+		int p = u < config.clWeight ? 0
+			: u < config.clWeight + config.ngWeight ? 1
+			: 2 + (int)(rng.next() % 2);
+		const GenProduct& prod = Products[p];
+		int i = nextMonth[p];
+		nextMonth[p] = (i + 1) % NumMonths;
+		int month = AddMonths(FirstMonth, i);
+		double f = forwards[p * NumMonths + i];
+		double t = (DayNumber(OptionsExpiry(month)) - DayNumber(ValueDate)) / 365.0;
+		double level = levels[p * NumMonths + i];
+
+		Pa2Line fut;
+		fut.put(0, "81NYM");
+		fut.put(5, prod.code);
+		fut.put(15, prod.code);
+		fut.put(25, "FUT");
+		fut.put(29, 6, month);
+		// NG's settlement digits sit two columns left of CL's
+		fut.put(110, 12, Ticks(f, prod.decimals, 9999) * (p == 1 ? 100 : 1));
+		bytes += fut.write(out);
+
+		for (double k = prod.strikeStep * ceil(0.5 * f / prod.strikeStep); k <= 1.5 * f && bytes < target;
+			k += prod.strikeStep)
+		{
+			double x = log(k / f);
+			double sigma = level - 0.1 * x + 0.25 * x * x;
+			for (int c = 0; c < 2; ++c)
+			{
+				char cp = c == 0 ? 'C' : 'P';
+				double price = Black76(cp, f, k, 0.02, t, sigma);
+				Pa2Line opt;
+				opt.put(0, "81NYM");
+				opt.put(5, prod.optCode);
+				opt.put(15, prod.code);
+				opt.put(25, "OOF");
+				opt.put(28, cp == 'C' ? "C" : "P");
+				opt.put(29, 6, month);
+				opt.put(38, 6, month);
+				opt.put(47, 7, Ticks(k, prod.decimals, 9999));
+				// a CL put has room for three settlement digits only
+				opt.put(110, 12, TicksUp(price, prod.decimals, p == 0 && cp == 'P' ? 999 : 9999));
+				bytes += opt.write(out);
+			}
+		}
+	}
+	return bytes;
+}
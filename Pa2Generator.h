@@ -0,0 +1,29 @@
+// File: Pa2Generator.h
+// Author(s): Jingyi Guo
+
+#include "Pa2Output.h"
+#ifndef _PA2_GENERATOR_
+#define _PA2_GENERATOR_
+
+// What to generate.  The mix weights say how many of the type 8
+// series (one futures settlement plus its option chain) belong to
+// CL, to NG, and to products the parser skips.
+struct Pa2GenConfig {
+    double megabytes;          // approximate size of the file
+    unsigned long long seed;   // same seed, same file
+    double clWeight;
+    double ngWeight;
+    double otherWeight;
+};
+
+// Write a synthetic SPAN pa2 file: type B expiry records for every
+// product and month, then type 8 settlement records until the size
+// is reached.  Each product and month has one futures settlement and
+// one smile, and its series comes round once per cycle through the
+// product's months, so a file of any size is one consistent day of
+// settlements.  Every column hw1.1 reads is filled in; option
+// settlements are Black-76 prices of the strike and futures
+// settlement as hw1.1 parses them, so implied vols can be solved.
+// Returns the number of bytes written.
+unsigned long long GeneratePa2(OutBuffer& out, const Pa2GenConfig& config);
+#endif
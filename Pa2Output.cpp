@@ -0,0 +1,403 @@
+// File: Pa2Output.cpp
+// Author(s): Jingyi Guo
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+#include "Pa2Output.h"
+
+/* ---------------- OutBuffer ----------------- */
+
+OutBuffer::OutBuffer(const string& fileName, size_t capacity)
+: d_file(0), d_owned(false), d_failed(false), d_buf(capacity < 64 ? 64 : capacity), d_used(0)
+{
+	if (fileName == "-")
+		d_file = stdout;
+	else
+	{
+		d_file = fopen(fileName.c_str(), "wb");
+		d_owned = true;
+	}
+}
+
+OutBuffer::~OutBuffer()
+{
+	drain();
+	if (d_file && d_owned)
+		fclose(d_file);
+	else if (d_file)
+		fflush(d_file);
+}
+
+void OutBuffer::drain()
+{
+	if (d_file && d_used && fwrite(&d_buf[0], 1, d_used, d_file) != d_used)
+		d_failed = true;
+	d_used = 0;
+}
+
+void OutBuffer::flush()
+{
+	drain();
+	if (d_file && fflush(d_file) != 0)
+		d_failed = true;
+}
+
+char* OutBuffer::reserve(size_t n)
+{
+	if (d_buf.size() - d_used < n)
+		drain();
+	return &d_buf[d_used];
+}
+
+void OutBuffer::put(const char* s, size_t n)
+{
+	if (n > d_buf.size())//too big to be worth copying
+	{
+		drain();
+		if (d_file && fwrite(s, 1, n, d_file) != n)
+			d_failed = true;
+		return;
+	}
+	memcpy(reserve(n), s, n);
+	d_used += n;
+}
+
+void OutBuffer::put(const char* s)
+{
+	put(s, strlen(s));
+}
+
+void OutBuffer::put_int(long value)
+{
+	char* p = reserve(24);
+	d_used = to_chars(p, p + 24, value).ptr - &d_buf[0];
+}
+
+void OutBuffer::put_double(double value)
+{
+	char* p = reserve(32);
+	d_used = to_chars(p, p + 32, value).ptr - &d_buf[0];
+}
+
+void OutBuffer::put_ticks(int ticks, int decimals)
+{
+	int scale = 1;
+	for (int i = 0; i < decimals; ++i)
+		scale *= 10;
+	if (ticks < 0)
+	{
+		put('-');
+		ticks = -ticks;
+	}
+	put_int(ticks / scale);
+	put('.');
+	char* p = reserve(decimals);
+	int frac = ticks % scale;
+	for (int i = decimals - 1; i >= 0; --i)
+	{
+		p[i] = '0' + frac % 10;
+		frac /= 10;
+	}
+	d_used += decimals;
+}
+
+void OutBuffer::put_ticks(int ticks, int intDigits, int decimals)
+{
+	char* p = reserve(intDigits + decimals + 1);
+	for (int i = intDigits + decimals; i >= 0; --i)
+	{
+		if (i == intDigits)
+		{
+			p[i] = '.';
+			continue;
+		}
+		p[i] = '0' + ticks % 10;
+		ticks /= 10;
+	}
+	d_used += intDigits + decimals + 1;
+}
+
+// yyyymm -> "yyyy-mm", and with dd -> "yyyy-mm-dd"
+static void PutMonth(OutBuffer& out, int yyyymm)
+{
+	out.put_int(yyyymm / 100);
+	out.put('-');
+	out.put('0' + yyyymm % 100 / 10);
+	out.put('0' + yyyymm % 10);
+}
+
+static void PutDate(OutBuffer& out, int yyyymmdd)
+{
+	PutMonth(out, yyyymmdd / 100);
+	out.put('-');
+	out.put('0' + yyyymmdd % 100 / 10);
+	out.put('0' + yyyymmdd % 10);
+}
+
+/* ---------------- ReportSink ----------------- */
+
+ReportSink::ReportSink(OutBuffer& out)
+: d_out(out)
+{
+	d_out.put("Futures   Contract   Contract   Futures     Options   Options\n");
+	d_out.put("Code      Month      Type       Exp Date    Code      Exp Date\n");
+	d_out.put("-------   --------   --------   --------    -------   --------\n");
+}
+
+void ReportSink::put(const Pa2Record& rec)
+{
+	if (rec.kind == PA2_SETTLE_SECTION)
+	{
+		d_out.put("\n");
+		d_out.put("Futures   Contract   Contract   Strike   Settlement\n");
+		d_out.put("Code      Month      Type       Price    Price\n");
+		d_out.put("-------   --------   --------   ------   ----------\n");
+		return;
+	}
+	d_out.put(rec.product, 2);//futures code
+	d_out.put("        ");
+	PutMonth(d_out, rec.contractMonth);//contract date
+	d_out.put("    ");
+	bool cl = rec.product[0] == 'C';
+	switch (rec.kind)
+	{
+	case PA2_FUT_EXPIRY:
+		d_out.put("Fut        ");//contract type
+		PutDate(d_out, rec.expDate);//expiration date
+		break;
+	case PA2_OPT_EXPIRY:
+		d_out.put("Opt                    ");//contract type
+		d_out.put(rec.optCode, 2);//options code
+		d_out.put("        ");
+		PutDate(d_out, rec.expDate);//expiration date
+		break;
+	case PA2_FUT_SETTLE:
+		d_out.put("Fut                 ");//contract type
+		d_out.put_ticks(rec.settleTicks, cl ? 2 : 1, rec.decimals);//settlement price
+		break;
+	case PA2_OPT_SETTLE:
+		d_out.put(rec.type == 'C' ? "Call       " : "Put        ");
+		d_out.put_ticks(rec.strikeTicks, 1, rec.decimals);//strike price
+		d_out.put("     ");
+		if (cl && rec.settleTicks >= 1000)
+			d_out.put_ticks(rec.settleTicks, 2, 2);//settlement price
+		else if (cl)
+		{
+			d_out.put(' ');
+			d_out.put_ticks(rec.settleTicks, 1, 2);
+		}
+		else
+			d_out.put_ticks(rec.settleTicks, 1, 3);
+		break;
+	default:
+		break;
+	}
+	d_out.put('\n');
+}
+
+/* ---------------- CsvSink ----------------- */
+
+CsvSink::CsvSink(OutBuffer& out)
+: d_out(out)
+{
+	d_out.put("kind,product,option_code,month,type,exp_date,strike,settle\n");
+}
+
+void CsvSink::put(const Pa2Record& rec)
+{
+	static const char* kinds[] = { "fut_exp", "opt_exp", "", "fut_settle", "opt_settle" };
+	if (rec.kind == PA2_SETTLE_SECTION)
+		return;
+	d_out.put(kinds[rec.kind]);
+	d_out.put(',');
+	d_out.put(rec.product, 2);
+	d_out.put(',');
+	if (rec.optCode[0])
+		d_out.put(rec.optCode, 2);
+	d_out.put(',');
+	PutMonth(d_out, rec.contractMonth);
+	d_out.put(',');
+	d_out.put(rec.type);
+	d_out.put(',');
+	if (rec.kind == PA2_FUT_EXPIRY || rec.kind == PA2_OPT_EXPIRY)
+		PutDate(d_out, rec.expDate);
+	d_out.put(',');
+	if (rec.kind == PA2_OPT_SETTLE)
+		d_out.put_ticks(rec.strikeTicks, rec.decimals);
+	d_out.put(',');
+	if (rec.kind == PA2_FUT_SETTLE || rec.kind == PA2_OPT_SETTLE)
+		d_out.put_ticks(rec.settleTicks, rec.decimals);
+	d_out.put('\n');
+}
+
+/* ---------------- BinarySink / ReadPa2Binary ----------------- */
+
+// first bytes of a binary record file
+struct BinaryHeader {
+	char magic[8];
+	int recordSize;
+	int version;
+};
+
+static BinaryHeader MakeHeader()
+{
+	BinaryHeader h;
+	memcpy(h.magic, "PA2REC\n", 8);
+	h.recordSize = sizeof(Pa2Record);
+	h.version = 1;
+	return h;
+}
+
+BinarySink::BinarySink(OutBuffer& out)
+: d_out(out)
+{
+	BinaryHeader h = MakeHeader();
+	d_out.put((const char*)&h, sizeof(h));
+}
+
+void BinarySink::put(const Pa2Record& rec)
+{
+	d_out.put((const char*)&rec, sizeof(rec));
+}
+
+long ReadPa2Binary(const string& fileName, Pa2RecordSink& sink)
+{
+	FILE* fin = fopen(fileName.c_str(), "rb");
+	if (!fin)
+		return -1;
+	BinaryHeader want = MakeHeader();
+	BinaryHeader h;
+	if (fread(&h, sizeof(h), 1, fin) != 1 || memcmp(&h, &want, sizeof(h)) != 0)
+	{
+		fclose(fin);
+		return -1;
+	}
+	long count = 0;
+	vector<Pa2Record> block(4096);
+	size_t n;
+	while ((n = fread(&block[0], sizeof(Pa2Record), block.size(), fin)) > 0)
+	{
+		for (size_t i = 0; i < n; ++i)
+			sink.put(block[i]);
+		count += n;
+	}
+	fclose(fin);
+	return count;
+}
+
+/* ---------------- ReadPa2Report ----------------- */
+
+// "48.33" or " 4.50" -> ticks and number of decimals
+static bool ParseTicks(const string& text, int& ticks, int& decimals)
+{
+	ticks = 0;
+	decimals = -1;
+	bool any = false;
+	for (size_t i = 0; i < text.size(); ++i)
+	{
+		char c = text[i];
+		if (c == ' ' || c == '\r')
+			continue;
+		if (c == '.')
+			decimals = 0;
+		else if (c >= '0' && c <= '9')
+		{
+			ticks = ticks * 10 + (c - '0');
+			if (decimals >= 0)
+				++decimals;
+			any = true;
+		}
+		else
+			return false;
+	}
+	if (decimals < 0)
+		decimals = 0;
+	return any;
+}
+
+// "2016-11" and "2016-10-17" -> 201611 and 20161017
+static int ParseDate(const string& line, size_t pos, int fields)
+{
+	int value = atoi(line.c_str() + pos);//year
+	for (int f = 1; f < fields; ++f)
+		value = value * 100 + atoi(line.c_str() + pos + 2 + 3 * f);//month, day
+	return value;
+}
+
+long ReadPa2Report(const string& fileName, Pa2RecordSink& sink)
+{
+	ifstream fin(fileName.c_str());
+	if (!fin)
+		return -1;
+	long count = 0;
+	bool settlements = false;
+	string line;
+	while (getline(fin, line))
+	{
+		if (line.compare(0, 7, "Futures") == 0 && line.find("Strike") != string::npos)
+		{
+			Pa2Record section = Pa2Record();
+			section.kind = PA2_SETTLE_SECTION;
+			sink.put(section);
+			settlements = true;
+			continue;
+		}
+		if (line.size() < 36 || line[0] == ' ' || line[0] == '-' || line.compare(0, 4, "Code") == 0
+			|| line.compare(0, 7, "Futures") == 0)
+			continue;
+		Pa2Record rec = Pa2Record();
+		rec.product[0] = line[0];
+		rec.product[1] = line[1];
+		rec.contractMonth = ParseDate(line, 10, 2);
+		string type = line.substr(21, 4);
+		if (!settlements)
+		{
+			if (type == "Fut ")
+			{
+				rec.kind = PA2_FUT_EXPIRY;
+				rec.type = 'F';
+				rec.expDate = ParseDate(line, 32, 3);
+			}
+			else if (type == "Opt " && line.size() >= 64)
+			{
+				rec.kind = PA2_OPT_EXPIRY;
+				rec.type = 'O';
+				rec.optCode[0] = line[44];
+				rec.optCode[1] = line[45];
+				rec.expDate = ParseDate(line, 54, 3);
+			}
+			else
+				continue;
+		}
+		else
+		{
+			int decimals;
+			if (type == "Fut ")
+			{
+				rec.kind = PA2_FUT_SETTLE;
+				rec.type = 'F';
+				if (!ParseTicks(line.substr(41), rec.settleTicks, rec.decimals))
+					continue;
+			}
+			else if ((type == "Call" || type == "Put ") && line.size() >= 42)
+			{
+				rec.kind = PA2_OPT_SETTLE;
+				rec.type = type[0];
+				if (!ParseTicks(line.substr(32, 6), rec.strikeTicks, rec.decimals)
+					|| !ParseTicks(line.substr(41), rec.settleTicks, decimals) || decimals != rec.decimals)
+					continue;
+			}
+			else
+				continue;
+		}
+		sink.put(rec);
+		++count;
+	}
+	return count;
+}
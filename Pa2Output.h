@@ -0,0 +1,84 @@
+// File: Pa2Output.h
+// Author(s): Jingyi Guo
+
+#include <cstdio>
+#include <string>
+#include <vector>
+using namespace std;
+#include "SpanParser.h"
+#ifndef _PA2_OUTPUT_
+#define _PA2_OUTPUT_
+
+// A large write buffer in front of a FILE*.  Everything is formatted
+// straight into the buffer (numbers with to_chars), and the buffer
+// goes out in one fwrite when it fills up.  ok() turns false if the
+// file would not open or a write to it failed; flush() first to see
+// the fate of what is still buffered.
+class OutBuffer {
+public:
+    OutBuffer(const string& fileName, size_t capacity = 1 << 20); // "-" is stdout
+    ~OutBuffer();              // flushes and closes
+    bool ok() const { return d_file != 0 && !d_failed; }
+    void put(char c)
+    {
+        if (d_used == d_buf.size()) drain();
+        d_buf[d_used++] = c;
+    }
+    void put(const char* s, size_t n);
+    void put(const char* s);
+    void put_int(long value);
+    void put_double(double value);              // shortest round-trip form
+    void put_ticks(int ticks, int decimals);    // 4500,2 -> 45.00
+    void put_ticks(int ticks, int intDigits, int decimals);  // zero padded
+    void flush();              // drain and fflush: for streaming output
+private:
+    OutBuffer(const OutBuffer&);            // not copyable
+    OutBuffer& operator=(const OutBuffer&);
+    char* reserve(size_t n);   // room for n more bytes
+    void drain();
+
+    FILE* d_file;
+    bool d_owned;
+    bool d_failed;             // a write or flush went wrong
+    vector<char> d_buf;
+    size_t d_used;
+};
+
+// The fixed-width CL/NG report of hw1.1
+class ReportSink : public Pa2RecordSink {
+public:
+    ReportSink(OutBuffer& out);
+    void put(const Pa2Record&);
+private:
+    OutBuffer& d_out;
+};
+
+// One CSV row per record:
+// kind,product,option_code,month,type,exp_date,strike,settle
+class CsvSink : public Pa2RecordSink {
+public:
+    CsvSink(OutBuffer& out);
+    void put(const Pa2Record&);
+private:
+    OutBuffer& d_out;
+};
+
+// Pa2Records written as they sit in memory, after a short header.
+// Only meant to be read back by ReadPa2Binary on the same kind of
+// machine (hw3.3 reads it without any text parsing).
+class BinarySink : public Pa2RecordSink {
+public:
+    BinarySink(OutBuffer& out);
+    void put(const Pa2Record&);
+private:
+    OutBuffer& d_out;
+};
+
+// Read a BinarySink file into sink; returns the number of records,
+// or -1 if the file cannot be opened or is not a record file.
+long ReadPa2Binary(const string& fileName, Pa2RecordSink& sink);
+
+// Read back a ReportSink report the same way; returns the number of
+// records, or -1 if the file cannot be opened.
+long ReadPa2Report(const string& fileName, Pa2RecordSink& sink);
+#endif
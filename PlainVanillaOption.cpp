@@ -11,6 +11,60 @@
 #include <algorithm>  // for max()
 #include <iomanip>    // for setw()
 using namespace std;
+#include "OptionMath.h"  // for Greeks, GreeksDual
+
+/* ---------------- Greeks on the binomial tree ----------------- */
+
+// The tree of binomialPrice, worked backwards in GreeksDual numbers
+// (one time step at a time) so that vega, theta, rho and volga come
+// out of the same pass as the price.  Delta and gamma are not taken
+// from S0 that way: the tree price is piecewise linear in S0 (piecewise
+// constant, for a digital), so its gamma is zero.  They come from the
+// nodes one and two steps in instead, and vanna is how that delta
+// moves with sigma.  payoff(stockPrice) gives the terminal values.
+template <class Payoff>
+Greeks binomialTreeGreeks(double s0, double rfr, double v, double et,
+                          int numIntervals, Payoff payoff)
+{
+    GreeksDual S0(s0), r(rfr, GREEKS_R), sigma(v, GREEKS_SIGMA), T(et, GREEKS_T);
+    GreeksDual deltaT = T / numIntervals;
+    GreeksDual sdt    = sigma * sqrt(deltaT);   // log of the up factor
+    GreeksDual u      = exp(sdt);
+    GreeksDual d      = 1 / u;
+    GreeksDual a      = exp(r * deltaT);
+    GreeksDual p      = (a - d) / (u - d);
+    GreeksDual q      = 1.0 - p;
+    GreeksDual disc   = exp(-r * deltaT);
+
+    vector<GreeksDual> optionPrice;
+    for (int j(0); j <= numIntervals; ++j)
+        optionPrice.push_back(payoff(S0 * exp(sdt * (2 * j - numIntervals))));
+
+    // step 2 and step 1 option prices, for delta and gamma
+    vector<GreeksDual> step2, step1;
+    for (int i(numIntervals-1); i >= 0; --i) {
+        for (int j(0); j <= i; ++j)
+            optionPrice[j] = disc * (p * optionPrice[j+1] + q * optionPrice[j]);
+        if (i == 2)
+            step2.assign(optionPrice.begin(), optionPrice.begin() + 3);
+        if (i == 1)
+            step1.assign(optionPrice.begin(), optionPrice.begin() + 2);
+    }
+
+    Greeks g = GreeksOf(optionPrice[0]);
+    if (numIntervals >= 2) {
+        GreeksDual su = S0 * u, sd = S0 * d;
+        GreeksDual suu = su * u, sdd = sd * d;
+        GreeksDual delta = (step1[1] - step1[0]) / (su - sd);
+        GreeksDual deltaUp   = (step2[2] - step2[1]) / (suu - S0);
+        GreeksDual deltaDown = (step2[1] - step2[0]) / (S0 - sdd);
+        GreeksDual gamma = (deltaUp - deltaDown) / ((suu - sdd) / 2.0);
+        g.delta = delta.v;
+        g.gamma = gamma.v;
+        g.vanna = delta.d[GREEKS_SIGMA];
+    }
+    return g;
+}
 
 /* ---------------- PlainVanillaOption class definition ----------------- */
 
@@ -88,6 +142,9 @@ public:
     // using the binomial tree method
     double binomialPrice(int numIntervals);
 
+    // Price and Greeks on the same tree, in one pass
+    Greeks binomialGreeks(int numIntervals);
+
     // ... other pricing methods can be added here ...
 
 };
@@ -183,6 +240,13 @@ double EuropeanCallOption::binomialPrice(int numIntervals)
 }
 
 
+Greeks EuropeanCallOption::binomialGreeks(int numIntervals)
+{
+    return binomialTreeGreeks(S0, r, sigma, T, numIntervals,
+                              [this](const GreeksDual& st) { return st > K ? st - K : GreeksDual(0.0); });
+}
+
+
 /* ---------------- EuropeanPutOption class definition ----------------- */
 
 class EuropeanPutOption {
@@ -214,6 +278,9 @@ public:
     // using the binomial tree method
     double binomialPrice(int numIntervals);
 
+    // Price and Greeks on the same tree, in one pass
+    Greeks binomialGreeks(int numIntervals);
+
     // ... other pricing methods can be added here ...
 
 };
@@ -308,6 +375,13 @@ double EuropeanPutOption::binomialPrice(int numIntervals)
     return binomialTree[0][0].optionPrice;
 }
 
+
+Greeks EuropeanPutOption::binomialGreeks(int numIntervals)
+{
+    return binomialTreeGreeks(S0, r, sigma, T, numIntervals,
+                              [this](const GreeksDual& st) { return st < K ? K - st : GreeksDual(0.0); });
+}
+
 /* ---------------- DigitalCall class definition ----------------- */
 
 class DigitalCall {
@@ -339,6 +413,9 @@ public:
     // using the binomial tree method
     double binomialPrice(int numIntervals);
 
+    // Price and Greeks on the same tree, in one pass
+    Greeks binomialGreeks(int numIntervals);
+
     // ... other pricing methods can be added here ...
 
 };
@@ -435,6 +512,13 @@ double DigitalCall::binomialPrice(int numIntervals)
 }
 
 
+Greeks DigitalCall::binomialGreeks(int numIntervals)
+{
+    return binomialTreeGreeks(S0, r, sigma, T, numIntervals,
+                              [this](const GreeksDual& st) { return GreeksDual(st >= K ? 1.0 : 0.0); });
+}
+
+
 /* ---------------- DigitalPut class definition ----------------- */
 
 class DigitalPut {
@@ -466,6 +550,9 @@ public:
     // using the binomial tree method
     double binomialPrice(int numIntervals);
 
+    // Price and Greeks on the same tree, in one pass
+    Greeks binomialGreeks(int numIntervals);
+
     // ... other pricing methods can be added here ...
 
 };
@@ -562,6 +649,13 @@ double DigitalPut::binomialPrice(int numIntervals)
 }
 
 
+Greeks DigitalPut::binomialGreeks(int numIntervals)
+{
+    return binomialTreeGreeks(S0, r, sigma, T, numIntervals,
+                              [this](const GreeksDual& st) { return GreeksDual(st <= K ? 1.0 : 0.0); });
+}
+
+
 int main()
 {
     int NI = 1000;
@@ -575,6 +669,17 @@ int main()
     cout << "Euro Call price, with " << NI << " intervals: "
          << ec9.binomialPrice(NI) << "\n";
 
+    Greeks tree = ec9.binomialGreeks(NI);
+    Greeks exact = BSMEuroCallGreeks(50.0, 50.0, 0.10, 0.4167, 0.40);
+    cout << "Euro Call Greeks, tree with " << NI << " intervals vs Black-Scholes:\n";
+    cout << "  delta " << setw(12) << tree.delta << setw(12) << exact.delta << "\n"
+         << "  gamma " << setw(12) << tree.gamma << setw(12) << exact.gamma << "\n"
+         << "  vega  " << setw(12) << tree.vega  << setw(12) << exact.vega  << "\n"
+         << "  theta " << setw(12) << tree.theta << setw(12) << exact.theta << "\n"
+         << "  rho   " << setw(12) << tree.rho   << setw(12) << exact.rho   << "\n"
+         << "  vanna " << setw(12) << tree.vanna << setw(12) << exact.vanna << "\n"
+         << "  volga " << setw(12) << tree.volga << setw(12) << exact.volga << "\n";
+
     EuropeanPutOption ep1( 50.0,     // current stock price, S0
                            50.0,     // option strike price, K
                            0.10,     // risk-free rate
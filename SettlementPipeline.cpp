@@ -0,0 +1,376 @@
+// File: SettlementPipeline.cpp
+// Author(s): Jingyi Guo
+//
+// Usage:  settle_pipeline [input [output]] [-d yyyymmdd] [-w threads] [-a]
+//   Reads a pa2 file, plain or gzip'd (default cme.20160826.c.pa2), and
+//   writes the Black-76 implied vol of every CL and NG option in it to
+//   output (default implied_vols.csv; "-" is stdout), in file order.
+//   -d  the settlement date, if the input is not named cme.yyyymmdd...
+//   -w  IV solver threads (default: hardware threads less two, at least one)
+//   -a  every contract month, not just hw1.1's 2016-10 through 2018-12
+//
+// Each stage is a thread, and the stages pass batches of typed
+// quotes through bounded queues; nothing is formatted and parsed
+// back in between:
+//   read + gunzip -> parse, match forward and expiry -> solve (n threads) -> write
+// The batches come from a fixed pool, so a stage that gets ahead
+// waits for a free batch, memory in flight is bounded, and nothing
+// is allocated per quote.  The one exception is an option that comes
+// before any futures settlement of its month: it is kept, in a
+// vector that grows as needed, until one arrives or the input ends.
+// pa2 files normally list a month's futures first, so that vector
+// stays empty, but a file in another order is held in memory in full.
+//
+// Build:  g++ -std=c++17 -O2 SettlementPipeline.cpp ImpliedVol.cpp SpanParser.cpp Pa2Output.cpp GzReader.cpp -lz -pthread -o settle_pipeline
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+using namespace std;
+#include "SpanParser.h"
+#include "Pa2Output.h"
+#include "GzReader.h"
+#include "ImpliedVol.h"
+#include "BoundedQueue.h"
+
+const double Rate = 0.02;          // as in hw3.3
+const size_t BatchSize = 512;      // quotes per batch: a few pages
+
+// An option settlement on its way through: the parse stage fills in
+// the first part, the solver the rest
+struct OptionQuote {
+	char product[3];
+	char type;                     // 'C' or 'P'
+	int contractMonth;             // yyyymm
+	int expiry;                    // yyyymmdd, 0 if unknown
+	double strike;
+	double settle;
+	double forward;                // NaN if the month has no futures settlement
+	double t;                      // years to expiry
+	double vol;
+	IVStatus status;
+	int iterations;
+};
+
+struct QuoteBatch {
+	long seq;                      // order in which the parse stage filled it
+	size_t size;
+	OptionQuote quotes[BatchSize];
+};
+
+typedef BoundedQueue<QuoteBatch*> BatchQueue;
+
+/* ---------------- parse stage ----------------- */
+
+// Keeps the latest futures settlement and options expiry of each
+// month, stamps them on each option and sends full batches on.  An
+// option that arrives before any futures settlement of its month
+// waits for one, in that month's waiting vector (unbounded).
+class QuoteMatcher : public Pa2RecordSink {
+public:
+	QuoteMatcher(BatchQueue& freeBatches, BatchQueue& out, int valueDate)
+	: d_free(freeBatches), d_out(out), d_today(DayNumber(valueDate)),
+	  d_lastKey(0), d_last(0), d_batch(0), d_seq(0)
+	{ }
+	void put(const Pa2Record& rec);
+	void finish();       // send everything, still waiting options too (with no forward)
+private:
+	struct Month {
+		bool hasForward;
+		double forward;
+		int expiry;
+		double t;            // years from the settlement date to expiry
+		vector<OptionQuote> waiting;
+	};
+	Month& month(const char* product, int yyyymm);
+	void stamp(OptionQuote& quote, const Month& m);
+	void emit(const OptionQuote& quote);
+
+	BatchQueue& d_free;
+	BatchQueue& d_out;
+	long d_today;
+	unordered_map<unsigned long long, Month> d_months;
+	unsigned long long d_lastKey;  // options come month by month: skip the hash
+	Month* d_last;
+	QuoteBatch* d_batch;           // being filled
+	long d_seq;
+};
+
+QuoteMatcher::Month& QuoteMatcher::month(const char* product, int yyyymm)
+{
+	unsigned long long key = ((unsigned long long)(unsigned char)product[0] << 40)
+		| ((unsigned long long)(unsigned char)product[1] << 32) | (unsigned)yyyymm;
+	if (d_last && key == d_lastKey)
+		return *d_last;
+	auto found = d_months.find(key);
+	if (found == d_months.end())
+	{
+		Month m = { false, numeric_limits<double>::quiet_NaN(), 0, 0.0, vector<OptionQuote>() };
+		found = d_months.insert(make_pair(key, m)).first;
+	}
+	d_lastKey = key;
+	d_last = &found->second;   // stays valid: elements never move in an unordered_map
+	return *d_last;
+}
+
+void QuoteMatcher::stamp(OptionQuote& quote, const Month& m)
+{
+	quote.forward = m.forward;
+	quote.expiry = m.expiry;
+	quote.t = m.t;
+}
+
+void QuoteMatcher::emit(const OptionQuote& quote)
+{
+	if (!d_batch)
+	{
+		d_free.pop(d_batch);
+		d_batch->seq = d_seq++;
+		d_batch->size = 0;
+	}
+	d_batch->quotes[d_batch->size++] = quote;
+	if (d_batch->size == BatchSize)
+	{
+		d_out.push(d_batch);
+		d_batch = 0;
+	}
+}
+
+void QuoteMatcher::put(const Pa2Record& rec)
+{
+	if (rec.kind == PA2_OPT_EXPIRY)
+	{
+		Month& m = month(rec.product, rec.contractMonth);
+		m.expiry = rec.expDate;
+		m.t = (DayNumber(rec.expDate) - d_today) / 365.0;
+	}
+	else if (rec.kind == PA2_FUT_SETTLE)
+	{
+		Month& m = month(rec.product, rec.contractMonth);
+		m.hasForward = true;
+		m.forward = rec.settle();
+		for (size_t i = 0; i < m.waiting.size(); ++i)
+		{
+			stamp(m.waiting[i], m);
+			emit(m.waiting[i]);
+		}
+		m.waiting.clear();
+	}
+	else if (rec.kind == PA2_OPT_SETTLE)
+	{
+		OptionQuote quote;
+		memcpy(quote.product, rec.product, sizeof(quote.product));
+		quote.type = rec.type;
+		quote.contractMonth = rec.contractMonth;
+		quote.strike = rec.strike();
+		quote.settle = rec.settle();
+		Month& m = month(rec.product, rec.contractMonth);
+		if (!m.hasForward)
+		{
+			m.waiting.push_back(quote);
+			return;
+		}
+		stamp(quote, m);
+		emit(quote);
+	}
+}
+
+void QuoteMatcher::finish()
+{
+	for (auto i = d_months.begin(); i != d_months.end(); ++i)
+		for (size_t j = 0; j < i->second.waiting.size(); ++j)
+		{
+			stamp(i->second.waiting[j], i->second);
+			emit(i->second.waiting[j]);
+		}
+	if (d_batch && d_batch->size > 0)
+		d_out.push(d_batch);
+	else if (d_batch)
+		d_free.push(d_batch);
+	d_batch = 0;
+}
+
+// read and parse the whole input into the matcher; false if it could not be read
+bool ParseStage(const string& inName, bool allMonths, QuoteMatcher& matcher)
+{
+	GzChunkReader reader(vector<string>(1, inName));
+	Pa2StreamParser parser(matcher, allMonths ? 0 : TimeInRange);
+	GzChunkReader::Chunk chunk;
+	bool ok = true;
+	while (reader.next(chunk))
+	{
+		if (chunk.failed)
+			ok = false;
+		parser.feed(chunk.data, chunk.size);
+	}
+	parser.finish();
+	matcher.finish();
+	return ok;
+}
+
+/* ---------------- solve stage ----------------- */
+
+void SolveStage(BatchQueue& in, BatchQueue& out, atomic<int>& running)
+{
+	QuoteBatch* batch;
+	while (in.pop(batch))
+	{
+		for (size_t i = 0; i < batch->size; ++i)
+		{
+			OptionQuote& q = batch->quotes[i];
+			//no forward or t <= 0 comes back as IV_BAD_INPUT
+			IVResult iv = Black76ImpliedVol(q.settle, q.forward, q.strike, Rate, q.t, q.type);
+			q.vol = iv.status == IV_OK ? iv.vol : numeric_limits<double>::quiet_NaN();
+			q.status = iv.status;
+			q.iterations = iv.iterations;
+		}
+		out.push(batch);
+	}
+	if (--running == 0)//the last solver out tells the writer
+		out.close();
+}
+
+/* ---------------- write stage ----------------- */
+
+void PutQuote(OutBuffer& out, const OptionQuote& q)
+{
+	static const char* statuses[] = { "ok", "below_intrinsic", "above_maximum", "bad_input", "no_convergence" };
+	out.put(q.product, 2);
+	out.put(',');
+	out.put_int(q.contractMonth);
+	out.put(',');
+	out.put(q.type);
+	out.put(',');
+	out.put_int(q.expiry);
+	out.put(',');
+	out.put_double(q.t);
+	out.put(',');
+	out.put_double(q.forward);
+	out.put(',');
+	out.put_double(q.strike);
+	out.put(',');
+	out.put_double(q.settle);
+	out.put(',');
+	out.put_double(q.vol);
+	out.put(',');
+	out.put(statuses[q.status]);
+	out.put(',');
+	out.put_int(q.iterations);
+	out.put('\n');
+}
+
+// solvers finish batches out of order: hold each until its turn
+long WriteStage(BatchQueue& in, BatchQueue& freeBatches, OutBuffer& out)
+{
+	out.put("product,month,type,expiry,t,forward,strike,settle,vol,status,iterations\n");
+	map<long, QuoteBatch*> early;
+	long next = 0, quotes = 0;
+	QuoteBatch* batch;
+	while (in.pop(batch))
+	{
+		early[batch->seq] = batch;
+		for (auto i = early.begin(); i != early.end() && i->first == next; i = early.erase(i), ++next)
+		{
+			for (size_t j = 0; j < i->second->size; ++j)
+				PutQuote(out, i->second->quotes[j]);
+			quotes += i->second->size;
+			freeBatches.push(i->second);
+		}
+	}
+	out.flush();
+	return quotes;
+}
+
+// yyyymmdd out of a name like .../cme.20160826.c.pa2.gz, 0 if none
+int DateFromName(const string& name)
+{
+	size_t at = name.rfind("cme.");
+	if (at == string::npos || name.size() < at + 12)
+		return 0;
+	int date = atoi(name.substr(at + 4, 8).c_str());
+	return ValidDate(date) ? date : 0;
+}
+
+int main(int argc, char* argv[])
+{
+	vector<string> names;
+	int valueDate = 0;
+	int threads = (int)thread::hardware_concurrency() - 2;
+	bool allMonths = false;
+	bool usage = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		if (arg == "-d" && i + 1 < argc)
+		{
+			valueDate = atoi(argv[++i]);
+			usage = usage || !ValidDate(valueDate);
+		}
+		else if (arg == "-w" && i + 1 < argc)
+			threads = atoi(argv[++i]);
+		else if (arg == "-a")
+			allMonths = true;
+		else if (arg[0] == '-' && arg != "-")
+			usage = true;
+		else
+			names.push_back(arg);
+	}
+	string inName = names.size() > 0 ? names[0] : "cme.20160826.c.pa2";
+	string outName = names.size() > 1 ? names[1] : "implied_vols.csv";
+	if (!valueDate)
+		valueDate = DateFromName(inName);
+	if (usage || names.size() > 2 || !valueDate)
+	{
+		cerr << "usage: " << argv[0] << " [input [output]] [-d yyyymmdd] [-w threads] [-a]\n";
+		return 1;
+	}
+	if (threads < 1)
+		threads = 1;
+
+	OutBuffer out(outName);
+	if (!out.ok())
+	{
+		cerr << "cannot write " << outName << "\n";
+		return 1;
+	}
+	// enough batches for every solver to hold one and the queues some more
+	size_t numBatches = 4 * threads + 4;
+	vector<QuoteBatch> pool(numBatches);
+	BatchQueue freeBatches(numBatches), parsed(numBatches), solved(numBatches);
+	for (size_t i = 0; i < numBatches; ++i)
+		freeBatches.push(&pool[i]);
+
+	QuoteMatcher matcher(freeBatches, parsed, valueDate);
+	bool readOk = true;
+	thread parse([&]() {
+		readOk = ParseStage(inName, allMonths, matcher);
+		parsed.close();
+	});
+	atomic<int> running(threads);
+	vector<thread> solvers;
+	for (int i = 0; i < threads; ++i)
+		solvers.push_back(thread(SolveStage, ref(parsed), ref(solved), ref(running)));
+	WriteStage(solved, freeBatches, out);
+	parse.join();
+	for (size_t i = 0; i < solvers.size(); ++i)
+		solvers[i].join();
+	if (!readOk)
+	{
+		cerr << "cannot read " << inName << "\n";
+		return 1;
+	}
+	if (!out.ok())
+	{
+		cerr << "cannot write " << outName << "\n";
+		return 1;
+	}
+	return 0;
+}
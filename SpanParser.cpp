@@ -0,0 +1,203 @@
+// File: SpanParser.cpp
+// Author(s): Jingyi Guo
+
+#include <cstring>
+#include <string>
+using namespace std;
+#include "SpanParser.h"
+
+// value of the n digits starting at p
+static int Digits(const char* p, int n)
+{
+	int value = 0;
+	for (int i = 0; i < n; ++i)
+		value = value * 10 + (p[i] - '0');
+	return value;
+}
+
+static double TicksToPrice(int ticks, int decimals)
+{
+	double scale = 1.0;
+	for (int i = 0; i < decimals; ++i)
+		scale *= 10.0;
+	return ticks / scale;
+}
+
+double Pa2Record::strike() const
+{
+	return TicksToPrice(strikeTicks, decimals);
+}
+
+double Pa2Record::settle() const
+{
+	return TicksToPrice(settleTicks, decimals);
+}
+
+bool TimeInRange(int yyyymm)
+{
+	int year = yyyymm / 100;
+	int month = yyyymm % 100;
+	if ((year <= 2016 && month < 10) || (year > 2018))
+		return false;
+	else
+		return true;
+}
+
+long DayNumber(int yyyymmdd)
+{
+	long y = yyyymmdd / 10000, m = yyyymmdd / 100 % 100, d = yyyymmdd % 100;
+	y -= m <= 2;
+	long era = (y >= 0 ? y : y - 399) / 400;
+	long yoe = y - era * 400;
+	long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+int DaysInMonth(int year, int month)
+{
+	static const int days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+	return days[month - 1] + (month == 2 && leap);
+}
+
+bool ValidDate(int yyyymmdd)
+{
+	int year = yyyymmdd / 10000, month = yyyymmdd / 100 % 100, day = yyyymmdd % 100;
+	return year >= 1 && year <= 9999 && month >= 1 && month <= 12 && day >= 1 && day <= DaysInMonth(year, month);
+}
+
+Pa2StreamParser::Pa2StreamParser(Pa2RecordSink& sink, bool (*monthFilter)(int))
+: d_sink(sink), d_monthFilter(monthFilter), d_before8(true), d_lines(0), d_records(0)
+{ }
+
+void Pa2StreamParser::feed(const char* buf, size_t n)
+{
+	const char* end = buf + n;
+	while (buf < end)
+	{
+		const char* nl = (const char*)memchr(buf, '\n', end - buf);
+		if (!nl)
+		{
+			d_partial.append(buf, end - buf);//wait for the rest of the line
+			return;
+		}
+		if (d_partial.empty())
+			parse_line(buf, nl - buf);//whole line is in this chunk: no copy
+		else
+		{
+			d_partial.append(buf, nl - buf);
+			parse_line(d_partial.data(), d_partial.size());
+			d_partial.clear();
+		}
+		buf = nl + 1;
+	}
+}
+
+void Pa2StreamParser::finish()
+{
+	if (d_partial.empty())
+		return;
+	parse_line(d_partial.data(), d_partial.size());
+	d_partial.clear();
+}
+
+void Pa2StreamParser::reset()
+{
+	d_partial.clear();
+	d_before8 = true;
+}
+
+void Pa2StreamParser::emit(Pa2Record& rec)
+{
+	++d_records;
+	d_sink.put(rec);
+}
+
+void Pa2StreamParser::parse_line(const char* line, size_t len)
+{
+	++d_lines;
+	Pa2Record rec = Pa2Record();
+	if (len > 0 && line[0] == 'B')//Type B records
+	{
+		if (len < 102)
+			return;
+		if (!((line[99] == 'C' && line[100] == 'L' && line[101] == ' ') || (line[99] == 'N' && line[100] == 'G' && line[101] == ' ')))//CL or NG
+			return;
+		rec.product[0] = line[99];
+		rec.product[1] = line[100];
+		rec.expDate = Digits(line + 91, 8);
+		if (line[15] == 'F' && line[16] == 'U' && line[17] == 'T')//Futures
+		{
+			rec.contractMonth = Digits(line + 18, 6);
+			if (d_monthFilter && !d_monthFilter(rec.contractMonth))
+				return;
+			rec.kind = PA2_FUT_EXPIRY;
+			rec.type = 'F';
+			emit(rec);
+		}
+		else if (line[15] == 'O' && line[16] == 'O' && line[17] == 'F' && ((line[5] == 'L' && line[6] == 'O') || (line[5] == 'O' && line[6] == 'N')))// LO or ON Options
+		{
+			rec.contractMonth = Digits(line + 27, 6);
+			if (d_monthFilter && !d_monthFilter(rec.contractMonth))
+				return;
+			rec.kind = PA2_OPT_EXPIRY;
+			rec.type = 'O';
+			rec.optCode[0] = line[5];
+			rec.optCode[1] = line[6];
+			emit(rec);
+		}
+		return;
+	}
+	if (len >= 5 && memcmp(line, "81NYM", 5) == 0)//Type 8 Records
+	{
+		if (d_before8)
+		{
+			Pa2Record section = Pa2Record();
+			section.kind = PA2_SETTLE_SECTION;
+			emit(section);
+			d_before8 = false;
+		}
+		if (len < 122)
+			return;
+		bool cl = line[15] == 'C' && line[16] == 'L' && line[17] == ' ';
+		bool ng = line[15] == 'N' && line[16] == 'G' && line[17] == ' ';
+		if (!cl && !ng)
+			return;
+		rec.product[0] = line[15];
+		rec.product[1] = line[16];
+		rec.decimals = cl ? 2 : 3;
+		if (line[25] == 'F' && line[26] == 'U' && line[27] == 'T')//Futures
+		{
+			rec.contractMonth = Digits(line + 29, 6);
+			if (d_monthFilter && !d_monthFilter(rec.contractMonth))
+				return;
+			rec.kind = PA2_FUT_SETTLE;
+			rec.type = 'F';
+			rec.settleTicks = cl ? Digits(line + 118, 4) : Digits(line + 116, 4);
+			emit(rec);
+		}
+		else if (line[25] == 'O' && line[26] == 'O' && line[27] == 'F' && (line[28] == 'C' || line[28] == 'P') && ((line[5] == 'L' && line[6] == 'O') || (line[5] == 'O' && line[6] == 'N')))//American Options
+		{
+			rec.contractMonth = Digits(line + 38, 6);
+			if (d_monthFilter && !d_monthFilter(rec.contractMonth))
+				return;
+			rec.kind = PA2_OPT_SETTLE;
+			rec.type = line[28];
+			rec.optCode[0] = line[5];
+			rec.optCode[1] = line[6];
+			if (ng)
+			{
+				rec.strikeTicks = Digits(line + 50, 4);
+				rec.settleTicks = Digits(line + 118, 4);
+			}
+			else
+			{
+				rec.strikeTicks = Digits(line + 51, 3);
+				//CL puts only carry three settlement digits
+				rec.settleTicks = rec.type == 'P' ? Digits(line + 119, 3) : Digits(line + 118, 4);
+			}
+			emit(rec);
+		}
+	}
+}
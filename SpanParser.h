@@ -0,0 +1,93 @@
+// File: SpanParser.h
+// Author(s): Jingyi Guo
+
+#include <string>
+#include <cstddef>
+using namespace std;
+#ifndef _SPAN_PARSER_
+#define _SPAN_PARSER_
+
+// What kind of line a Pa2Record came from
+enum Pa2Kind {
+    PA2_FUT_EXPIRY,      // type B futures record
+    PA2_OPT_EXPIRY,      // type B options record
+    PA2_SETTLE_SECTION,  // first type 8 record of a file: settlements start
+    PA2_FUT_SETTLE,      // type 8 futures settlement
+    PA2_OPT_SETTLE       // type 8 options settlement
+};
+
+// One parsed CL/NG record.  Prices are kept as integer ticks
+// (the digits as they appear in the file) so the fixed-width
+// report can be rebuilt digit for digit.
+struct Pa2Record {
+    Pa2Kind kind;
+    char product[3];     // futures code: "CL" or "NG"
+    char optCode[3];     // options code: "LO" or "ON" (options only)
+    char type;           // 'F' futures, 'O' option expiry, 'C' call, 'P' put
+    int contractMonth;   // yyyymm
+    int expDate;         // yyyymmdd (expiry records only)
+    int strikeTicks;     // strike price in ticks (options settlements)
+    int settleTicks;     // settlement price in ticks (settlements)
+    int decimals;        // implied decimals of the ticks: 2 for CL, 3 for NG
+
+    double strike() const;
+    double settle() const;
+};
+
+// Anything that consumes parsed records
+class Pa2RecordSink {
+public:
+    virtual void put(const Pa2Record&) = 0;
+    virtual ~Pa2RecordSink() {}
+};
+
+// Hands every record to two sinks
+class TeeSink : public Pa2RecordSink {
+public:
+    TeeSink(Pa2RecordSink& first, Pa2RecordSink& second)
+    : d_first(first), d_second(second) { }
+    void put(const Pa2Record& rec) { d_first.put(rec); d_second.put(rec); }
+private:
+    Pa2RecordSink& d_first;
+    Pa2RecordSink& d_second;
+};
+
+// hw1.1's filter: contract months from 2016-10 through 2018-12
+bool TimeInRange(int yyyymm);
+
+// days since 1970-01-01, for day counts between yyyymmdd dates
+long DayNumber(int yyyymmdd);
+
+// days in month (1-12) of year
+int DaysInMonth(int year, int month);
+
+// is yyyymmdd a real date
+bool ValidDate(int yyyymmdd);
+
+// Incremental pa2 parser.  Input may be handed over in chunks of
+// any size (split anywhere, even mid-line); a partial last line is
+// kept until the rest of it arrives.  Each complete line is parsed
+// as soon as it is seen, so records reach the sink with no more
+// delay than the line itself.
+class Pa2StreamParser {
+public:
+    // monthFilter may be 0 to keep every contract month
+    Pa2StreamParser(Pa2RecordSink& sink,
+                    bool (*monthFilter)(int) = TimeInRange);
+    void feed(const char* buf, size_t n);  // parse what has arrived
+    void finish();       // end of input: parse a final unterminated line
+    void reset();        // start over on a new file
+    long lines() const { return d_lines; }
+    long records() const { return d_records; }
+private:
+    void parse_line(const char* line, size_t len);
+    void emit(Pa2Record& rec);
+
+    Pa2RecordSink& d_sink;
+    bool (*d_monthFilter)(int);
+    string d_partial;    // unterminated tail of the last chunk
+    bool d_before8;      // still in the type B section?
+    long d_lines;
+    long d_records;
+};
+#endif
@@ -0,0 +1,424 @@
+// File: SviSmile.cpp
+// Author(s): Jingyi Guo
+//
+// The fit follows Zeliade's quasi-explicit calibration: with m and
+// sigma fixed, y = (k - m) / sigma turns the smile into
+//     w = a + d y + c sqrt(y^2 + 1),   d = rho b sigma, c = b sigma
+// which is linear in (a, d, c), and the no-arbitrage conditions are
+// a polytope in (a, d, c).  That small quadratic program is solved
+// exactly for every (m, sigma) a Nelder-Mead search tries.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+using namespace std;
+#include "SviSmile.h"
+
+double SviParams::total_variance(double k) const
+{
+	double x = k - m;
+	return a + b * (rho * x + sqrt(x * x + sigma * sigma));
+}
+
+/* ---------------- calibration ----------------- */
+
+struct SmileQuote {
+	double k;   // ln(K/F)
+	double w;   // vol^2 t
+};
+
+// Gaussian elimination with partial pivoting on an n x n row-major
+// matrix; the solution replaces rhs.  false if singular.
+static bool SolveLinear(double* a, double* rhs, int n)
+{
+	for (int col = 0; col < n; ++col)
+	{
+		int pivot = col;
+		for (int row = col + 1; row < n; ++row)
+			if (fabs(a[row * n + col]) > fabs(a[pivot * n + col]))
+				pivot = row;
+		if (fabs(a[pivot * n + col]) < 1e-300)
+			return false;
+		if (pivot != col)
+		{
+			for (int j = 0; j < n; ++j)
+				swap(a[col * n + j], a[pivot * n + j]);
+			swap(rhs[col], rhs[pivot]);
+		}
+		for (int row = col + 1; row < n; ++row)
+		{
+			double f = a[row * n + col] / a[col * n + col];
+			for (int j = col; j < n; ++j)
+				a[row * n + j] -= f * a[col * n + j];
+			rhs[row] -= f * rhs[col];
+		}
+	}
+	for (int row = n - 1; row >= 0; --row)
+	{
+		double s = rhs[row];
+		for (int j = row + 1; j < n; ++j)
+			s -= a[row * n + j] * rhs[j];
+		rhs[row] = s / a[row * n + row];
+	}
+	return true;
+}
+
+struct LinearFit {
+	double a, d, c;
+	double sse;
+};
+
+// Best (a, d, c) for fixed m and sigma, subject to
+//     0 <= a <= wmax,  |d| <= c,  c + |d| <= 2 sigma
+// The optimum of a convex quadratic over a polytope is the
+// equality-constrained optimum of one of its faces, so every set of
+// zero to three active constraints is tried and the best feasible
+// answer kept (the vertex a = d = c = 0 always is one).
+static LinearFit FitLinear(const vector<SmileQuote>& quotes, double m, double sigma, double wmax)
+{
+	double q[3][3] = { { 0 } }, g[3] = { 0 }, ww = 0;
+	for (size_t i = 0; i < quotes.size(); ++i)
+	{
+		double y = (quotes[i].k - m) / sigma;
+		double v[3] = { 1.0, y, sqrt(y * y + 1) };
+		for (int r = 0; r < 3; ++r)
+		{
+			for (int c = 0; c < 3; ++c)
+				q[r][c] += v[r] * v[c];
+			g[r] += v[r] * quotes[i].w;
+		}
+		ww += quotes[i].w * quotes[i].w;
+	}
+	static const double G[6][3] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, 1, -1 }, { 0, -1, -1 },
+		{ 0, 1, 1 }, { 0, -1, 1 } };
+	double h[6] = { 0, wmax, 0, 0, 2 * sigma, 2 * sigma };
+
+	LinearFit best = { 0, 0, 0, ww };
+	for (int active = 0; active < 64; ++active)
+	{
+		int rows[6], r = 0;
+		for (int i = 0; i < 6; ++i)
+			if (active & (1 << i))
+				rows[r++] = i;
+		if (r > 3)
+			continue;
+		// KKT system [Q G'; G 0] [p; lambda] = [g; h]
+		int n = 3 + r;
+		double kkt[36] = { 0 }, rhs[6];
+		for (int i = 0; i < 3; ++i)
+		{
+			for (int j = 0; j < 3; ++j)
+				kkt[i * n + j] = q[i][j];
+			rhs[i] = g[i];
+		}
+		for (int c = 0; c < r; ++c)
+		{
+			for (int j = 0; j < 3; ++j)
+			{
+				kkt[(3 + c) * n + j] = G[rows[c]][j];
+				kkt[j * n + 3 + c] = G[rows[c]][j];
+			}
+			rhs[3 + c] = h[rows[c]];
+		}
+		if (!SolveLinear(kkt, rhs, n))
+			continue;
+		bool feasible = true;
+		for (int i = 0; i < 6 && feasible; ++i)
+			feasible = G[i][0] * rhs[0] + G[i][1] * rhs[1] + G[i][2] * rhs[2] <= h[i] + 1e-12 * (1 + fabs(h[i]));
+		if (!feasible)
+			continue;
+		double sse = ww;
+		for (int i = 0; i < 3; ++i)
+		{
+			sse -= 2 * g[i] * rhs[i];
+			for (int j = 0; j < 3; ++j)
+				sse += rhs[i] * q[i][j] * rhs[j];
+		}
+		if (sse < best.sse)
+		{
+			LinearFit fit = { rhs[0], rhs[1], rhs[2], sse };
+			best = fit;
+		}
+	}
+	return best;
+}
+
+static const double SigmaMin = 1e-3, SigmaMax = 2.0;
+
+// Everything the search needs to score an (m, sigma)
+class SmileObjective {
+public:
+	SmileObjective(const vector<SmileQuote>& quotes)
+	: d_quotes(quotes), d_wmax(0), d_kmin(quotes[0].k), d_kmax(quotes[0].k), d_evaluations(0)
+	{
+		for (size_t i = 0; i < quotes.size(); ++i)
+		{
+			d_wmax = max(d_wmax, quotes[i].w);
+			d_kmin = min(d_kmin, quotes[i].k);
+			d_kmax = max(d_kmax, quotes[i].k);
+		}
+	}
+	// m and sigma are pulled back into range first
+	LinearFit operator()(double& m, double& sigma)
+	{
+		double span = d_kmax - d_kmin;
+		m = min(max(m, d_kmin - span), d_kmax + span);
+		sigma = min(max(sigma, SigmaMin), SigmaMax);
+		++d_evaluations;
+		return FitLinear(d_quotes, m, sigma, d_wmax);
+	}
+	double kmin() const { return d_kmin; }
+	double kmax() const { return d_kmax; }
+	int evaluations() const { return d_evaluations; }
+private:
+	const vector<SmileQuote>& d_quotes;
+	double d_wmax, d_kmin, d_kmax;
+	int d_evaluations;
+};
+
+// Nelder-Mead over (m, sigma) from a start and initial step sizes
+static SviParams FitSmile(SmileObjective& objective, double m0, double sigma0,
+	double stepM, double stepSigma, double& sse)
+{
+	double x[3][2] = { { m0, sigma0 }, { m0 + stepM, sigma0 }, { m0, sigma0 + stepSigma } };
+	double f[3];
+	for (int i = 0; i < 3; ++i)
+		f[i] = objective(x[i][0], x[i][1]).sse;
+	for (int iter = 0; iter < 300; ++iter)
+	{
+		// order best .. worst
+		for (int i = 0; i < 3; ++i)
+			for (int j = i + 1; j < 3; ++j)
+				if (f[j] < f[i])
+				{
+					swap(f[i], f[j]);
+					swap(x[i][0], x[j][0]);
+					swap(x[i][1], x[j][1]);
+				}
+		double size = max(max(fabs(x[1][0] - x[0][0]), fabs(x[2][0] - x[0][0])),
+			max(fabs(x[1][1] - x[0][1]), fabs(x[2][1] - x[0][1])));
+		if (size < 1e-6 || f[2] - f[0] <= 1e-10 * f[0])
+			break;
+		double c[2] = { (x[0][0] + x[1][0]) / 2, (x[0][1] + x[1][1]) / 2 };
+		double r[2] = { 2 * c[0] - x[2][0], 2 * c[1] - x[2][1] };
+		double fr = objective(r[0], r[1]).sse;
+		if (fr < f[0])
+		{
+			double e[2] = { 3 * c[0] - 2 * x[2][0], 3 * c[1] - 2 * x[2][1] };
+			double fe = objective(e[0], e[1]).sse;
+			bool expand = fe < fr;
+			x[2][0] = expand ? e[0] : r[0];
+			x[2][1] = expand ? e[1] : r[1];
+			f[2] = expand ? fe : fr;
+		}
+		else if (fr < f[1])
+		{
+			x[2][0] = r[0];
+			x[2][1] = r[1];
+			f[2] = fr;
+		}
+		else
+		{
+			// contract towards the better of the worst point and its reflection
+			bool outside = fr < f[2];
+			double k[2] = { (c[0] + (outside ? r[0] : x[2][0])) / 2, (c[1] + (outside ? r[1] : x[2][1])) / 2 };
+			double fk = objective(k[0], k[1]).sse;
+			if (fk < min(fr, f[2]))
+			{
+				x[2][0] = k[0];
+				x[2][1] = k[1];
+				f[2] = fk;
+			}
+			else
+				for (int i = 1; i < 3; ++i)//shrink towards the best
+				{
+					x[i][0] = (x[i][0] + x[0][0]) / 2;
+					x[i][1] = (x[i][1] + x[0][1]) / 2;
+					f[i] = objective(x[i][0], x[i][1]).sse;
+				}
+		}
+	}
+	int best = 0;
+	for (int i = 1; i < 3; ++i)
+		if (f[i] < f[best])
+			best = i;
+	double m = x[best][0], sigma = x[best][1];
+	LinearFit fit = objective(m, sigma);
+	sse = fit.sse;
+	SviParams params;
+	params.a = fit.a;
+	params.b = fit.c / sigma;
+	params.rho = fit.c > 0 ? fit.d / fit.c : 0;
+	params.m = m;
+	params.sigma = sigma;
+	return params;
+}
+
+// FNV-1a over the bytes of the quotes
+static unsigned long long Checksum(const vector<SmileQuote>& quotes, double t, double forward)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	auto mix = [&hash](double v) {
+		unsigned char bytes[sizeof(v)];
+		memcpy(bytes, &v, sizeof(v));
+		for (size_t i = 0; i < sizeof(v); ++i)
+			hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	};
+	mix(t);
+	mix(forward);
+	for (size_t i = 0; i < quotes.size(); ++i)
+	{
+		mix(quotes[i].k);
+		mix(quotes[i].w);
+	}
+	return hash;
+}
+
+SviCalibrator::SviCalibrator()
+{ }
+
+int SviCalibrator::calibrate(const vector<VolSlice>& surface)
+{
+	vector<SviSlice> fitted;
+	vector<SmileQuote> quotes;
+	size_t previous = 0;
+	int refits = 0;
+	for (size_t first = 0, last; first < surface.size(); first = last)
+	{
+		//the calls and puts of a month are next to each other
+		const VolSlice& head = surface[first];
+		for (last = first + 1; last < surface.size() && surface[last].contractMonth == head.contractMonth
+			&& strncmp(surface[last].product, head.product, 2) == 0; ++last)
+			;
+		quotes.clear();
+		for (size_t s = first; s < last; ++s)
+			for (size_t i = 0; i < surface[s].points.size(); ++i)
+			{
+				const VolPoint& p = surface[s].points[i];
+				bool otm = (surface[s].type == 'C') == (p.strike >= surface[s].forward);
+				if (p.status != IV_OK || !otm)
+					continue;
+				SmileQuote quote = { log(p.strike / surface[s].forward), p.vol * p.vol * surface[s].t };
+				quotes.push_back(quote);
+			}
+		if (quotes.size() < 5)
+			continue;
+
+		SviSlice slice;
+		memcpy(slice.product, head.product, sizeof(slice.product));
+		slice.contractMonth = head.contractMonth;
+		slice.t = head.t;
+		slice.forward = head.forward;
+		slice.points = (int)quotes.size();
+		slice.checksum = Checksum(quotes, slice.t, slice.forward);
+
+		// last calibration's fit of this month, if any (both lists are sorted)
+		const SviSlice* prev = 0;
+		for (; previous < d_slices.size(); ++previous)
+		{
+			int cmp = strncmp(d_slices[previous].product, head.product, 2);
+			if (cmp > 0 || (cmp == 0 && d_slices[previous].contractMonth >= head.contractMonth))
+				break;
+		}
+		if (previous < d_slices.size() && d_slices[previous].contractMonth == head.contractMonth
+			&& strncmp(d_slices[previous].product, head.product, 2) == 0)
+			prev = &d_slices[previous];
+		if (prev && prev->checksum == slice.checksum)
+		{
+			fitted.push_back(*prev);
+			continue;
+		}
+
+		SmileObjective objective(quotes);
+		double span = objective.kmax() - objective.kmin() + 0.01;
+		double sse;
+		if (prev)
+			slice.params = FitSmile(objective, prev->params.m, prev->params.sigma, 0.001 * span,
+				0.005 * prev->params.sigma, sse);
+		else
+		{
+			// cold start: m at the bottom of the smile
+			size_t low = 0;
+			for (size_t i = 1; i < quotes.size(); ++i)
+				if (quotes[i].w < quotes[low].w)
+					low = i;
+			slice.params = FitSmile(objective, quotes[low].k, 0.1, 0.2 * span, 0.1, sse);
+		}
+		//sse from the normal equations can cancel to below zero on an exact fit
+		sse = 0;
+		for (size_t i = 0; i < quotes.size(); ++i)
+		{
+			double e = slice.params.total_variance(quotes[i].k) - quotes[i].w;
+			sse += e * e;
+		}
+		slice.rmse = sqrt(sse / quotes.size());
+		slice.evaluations = objective.evaluations();
+		fitted.push_back(slice);
+		++refits;
+	}
+	d_slices.swap(fitted);
+	return refits;
+}
+
+/* ---------------- queries ----------------- */
+
+bool SviSurface::build(const vector<SviSlice>& slices, const char* product)
+{
+	d_t.clear();
+	d_forward.clear();
+	d_params.clear();
+	for (size_t i = 0; i < slices.size(); ++i)
+		if (strncmp(slices[i].product, product, 2) == 0 && slices[i].t > 0)
+		{
+			//later months expire later, so t stays ascending
+			d_t.push_back(slices[i].t);
+			d_forward.push_back(slices[i].forward);
+			d_params.push_back(slices[i].params);
+		}
+	return !d_t.empty();
+}
+
+size_t SviSurface::locate(double t) const
+{
+	return lower_bound(d_t.begin(), d_t.end(), t) - d_t.begin();
+}
+
+double SviSurface::total_variance(double t, double k) const
+{
+	size_t n = d_t.size();
+	if (n == 0)
+		return numeric_limits<double>::quiet_NaN();
+	size_t i = locate(t);
+	if (i == 0)
+		return d_params[0].total_variance(k) * t / d_t[0];
+	if (i == n)
+		return d_params[n - 1].total_variance(k) * t / d_t[n - 1];
+	double lambda = (t - d_t[i - 1]) / (d_t[i] - d_t[i - 1]);
+	double w0 = d_params[i - 1].total_variance(k);
+	return w0 + lambda * (d_params[i].total_variance(k) - w0);
+}
+
+double SviSurface::vol(double t, double k) const
+{
+	return sqrt(total_variance(t, k) / t);
+}
+
+double SviSurface::forward(double t) const
+{
+	size_t n = d_t.size();
+	if (n == 0)
+		return numeric_limits<double>::quiet_NaN();
+	size_t i = locate(t);
+	if (i == 0)
+		return d_forward[0];
+	if (i == n)
+		return d_forward[n - 1];
+	double lambda = (t - d_t[i - 1]) / (d_t[i] - d_t[i - 1]);
+	return d_forward[i - 1] + lambda * (d_forward[i] - d_forward[i - 1]);
+}
+
+double SviSurface::vol_at_strike(double t, double strike) const
+{
+	return vol(t, log(strike / forward(t)));
+}
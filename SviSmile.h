@@ -0,0 +1,77 @@
+// File: SviSmile.h
+// Author(s): Jingyi Guo
+//
+// Raw SVI smiles fitted to a vol surface, and a query object for
+// vol and total variance at any strike and maturity.  In log
+// moneyness k = ln(K/F) the total implied variance of one expiry is
+//     w(k) = a + b (rho (k - m) + sqrt((k - m)^2 + sigma^2))
+// and the implied vol is sqrt(w / t).
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+#include "VolSurface.h"
+#ifndef _SVI_SMILE_
+#define _SVI_SMILE_
+
+struct SviParams {
+    double a, b, rho, m, sigma;
+
+    double total_variance(double k) const;
+};
+
+// The fitted smile of one (product, contract month)
+struct SviSlice {
+    char product[3];
+    int contractMonth;       // yyyymm
+    double t;                // years to expiry
+    double forward;
+    SviParams params;
+    double rmse;             // of the fit, in total variance
+    int points;              // quotes it was fitted to
+    int evaluations;         // objective evaluations the fit took
+    unsigned long long checksum;   // of the quotes, to spot changes
+};
+
+// Fits every expiry of a surface, keeping the last fits so that the
+// next calibrate() only refits expiries whose quotes changed, each
+// starting from its previous parameters.  A fit uses the out of the
+// money side of each strike (puts below the forward, calls above)
+// and needs at least five solved vols.  Within an expiry the fit is
+// free of butterfly arbitrage in the wings (b (1 + |rho|) <= 2,
+// Roger Lee's bound) and never goes below zero variance; nothing
+// ties one expiry to the next, so calendar arbitrage is possible.
+class SviCalibrator {
+public:
+    SviCalibrator();
+    // returns how many expiries were (re)fitted
+    int calibrate(const vector<VolSlice>& surface);
+    const vector<SviSlice>& slices() const { return d_slices; }  // by product, month
+private:
+    vector<SviSlice> d_slices;
+};
+
+// Fitted smiles of one product, for repricing.  Lookups are a
+// binary search over the expiries and a few flops, and never
+// allocate.  Between expiries total variance is interpolated
+// linearly in t at the same k; before the first it shrinks to 0 in
+// proportion to t, after the last it grows in proportion to t.
+class SviSurface {
+public:
+    SviSurface() { }
+    // the product's slices out of a calibrator; false if there are none
+    bool build(const vector<SviSlice>& slices, const char* product);
+
+    double total_variance(double t, double k) const;
+    double vol(double t, double k) const;          // k = ln(K / forward(t))
+    double forward(double t) const;                // interpolated linearly in t
+    double vol_at_strike(double t, double strike) const;
+    size_t expiries() const { return d_t.size(); }
+private:
+    size_t locate(double t) const;                 // first expiry at or after t
+
+    vector<double> d_t;      // ascending
+    vector<double> d_forward;
+    vector<SviParams> d_params;
+};
+#endif
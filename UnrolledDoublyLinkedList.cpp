@@ -0,0 +1,325 @@
+// File: UnrolledDoublyLinkedList.cpp
+// Author(s): Jingyi Guo
+
+#include <iostream>
+#include <cstring>
+using namespace std;
+#include "UnrolledDoublyLinkedList.h"
+
+// values per chunk: a chunk, links and all, is 512 bytes
+const int ChunkValues = (512 - 2 * sizeof(void*) - 2 * sizeof(int)) / sizeof(int);
+
+// A chunk's values are values[first] .. values[first + count - 1].
+// A chunk added at the back fills from values[0] up, one added at
+// the front from values[ChunkValues - 1] down, so pushes at either
+// end never move a value.
+struct UnrolledDoublyLinkedList::Chunk {
+	Chunk *next;
+	Chunk *prev;
+	int first;
+	int count;
+	int values[ChunkValues];
+};
+
+typedef UnrolledDoublyLinkedList::Chunk chunk;
+
+UnrolledDoublyLinkedList::UnrolledDoublyLinkedList()
+: d_head(0), d_tail(0), d_spare(0), d_size(0), d_sum(0)
+{ }
+
+UnrolledDoublyLinkedList::UnrolledDoublyLinkedList(int val)
+: UnrolledDoublyLinkedList()
+{
+	push_back(val);
+}
+
+UnrolledDoublyLinkedList::UnrolledDoublyLinkedList(int val1, int val2)
+: UnrolledDoublyLinkedList()
+{
+	push_back(val1);
+	push_back(val2);
+}
+
+UnrolledDoublyLinkedList::UnrolledDoublyLinkedList(initializer_list<int> values)
+: UnrolledDoublyLinkedList()
+{
+	for (const int *p = values.begin(); p != values.end(); ++p)
+		push_back(*p);
+}
+
+UnrolledDoublyLinkedList::~UnrolledDoublyLinkedList()//destructor
+{
+	clear();
+	delete d_spare;
+}
+
+chunk* UnrolledDoublyLinkedList::new_chunk()
+{
+	chunk *c = d_spare ? d_spare : new chunk;
+	d_spare = 0;
+	return c;
+}
+
+void UnrolledDoublyLinkedList::free_chunk(chunk* c)
+{
+	if (d_spare)
+		delete c;
+	else
+		d_spare = c;
+}
+
+void UnrolledDoublyLinkedList::clear()
+{
+	for (chunk *c = d_head; c;)
+	{
+		chunk *temp = c->next;
+		free_chunk(c);
+		c = temp;
+	}
+	d_head = d_tail = 0;
+	d_size = 0;
+	d_sum = 0;
+}
+
+void UnrolledDoublyLinkedList::push_back(int val)
+{
+	++d_size;
+	d_sum += val;
+	if (d_tail && d_tail->first + d_tail->count < ChunkValues)
+	{
+		d_tail->values[d_tail->first + d_tail->count++] = val;
+		return;
+	}
+	chunk *c = new_chunk();
+	c->first = 0;
+	c->count = 1;
+	c->values[0] = val;
+	c->next = 0;
+	c->prev = d_tail;
+	if (d_tail)
+		d_tail->next = c;
+	else
+		d_head = c;
+	d_tail = c;
+}
+
+void UnrolledDoublyLinkedList::push_front(int val)
+{
+	++d_size;
+	d_sum += val;
+	if (d_head && d_head->first > 0)
+	{
+		d_head->values[--d_head->first] = val;
+		++d_head->count;
+		return;
+	}
+	chunk *c = new_chunk();
+	c->first = ChunkValues - 1;
+	c->count = 1;
+	c->values[c->first] = val;
+	c->prev = 0;
+	c->next = d_head;
+	if (d_head)
+		d_head->prev = c;
+	else
+		d_tail = c;
+	d_head = c;
+}
+
+void UnrolledDoublyLinkedList::pop_back()
+{
+	if (!d_tail)
+		return;
+	--d_size;
+	d_sum -= d_tail->values[d_tail->first + --d_tail->count];
+	if (d_tail->count > 0)
+		return;
+	chunk *empty = d_tail;
+	d_tail = empty->prev;
+	if (d_tail)
+		d_tail->next = 0;
+	else
+		d_head = 0;
+	free_chunk(empty);
+}
+
+void UnrolledDoublyLinkedList::pop_front()
+{
+	if (!d_head)
+		return;
+	--d_size;
+	d_sum -= d_head->values[d_head->first++];
+	if (--d_head->count > 0)
+		return;
+	chunk *empty = d_head;
+	d_head = empty->next;
+	if (d_head)
+		d_head->prev = 0;
+	else
+		d_tail = 0;
+	free_chunk(empty);
+}
+
+int UnrolledDoublyLinkedList::front() const
+{
+	if (!d_head)
+		return 0;
+	return d_head->values[d_head->first];
+}
+
+int UnrolledDoublyLinkedList::back() const
+{
+	if (!d_tail)
+		return 0;
+	return d_tail->values[d_tail->first + d_tail->count - 1];
+}
+
+UnrolledDoublyLinkedList::UnrolledDoublyLinkedList(const UnrolledDoublyLinkedList & other)
+: UnrolledDoublyLinkedList()
+{
+	*this = other;
+}
+
+// chunk by chunk, writing over the chunks we have, packed from the front
+UnrolledDoublyLinkedList & UnrolledDoublyLinkedList::operator=(const UnrolledDoublyLinkedList & other)
+{
+	if (this == &other)
+		return *this;
+	chunk *mine = d_head, *last = 0;
+	const chunk *theirs = other.d_head;
+	int from = theirs ? theirs->first : 0;
+	while (theirs)
+	{
+		if (!mine)
+		{
+			mine = new_chunk();
+			mine->next = 0;
+			mine->prev = last;
+			if (last)
+				last->next = mine;
+			else
+				d_head = mine;
+		}
+		//as many of theirs as fit, from where we are in their chunk
+		int n = theirs->first + theirs->count - from;
+		if (n > ChunkValues)
+			n = ChunkValues;
+		memcpy(mine->values, theirs->values + from, n * sizeof(int));
+		mine->first = 0;
+		mine->count = n;
+		from += n;
+		if (from == theirs->first + theirs->count)
+		{
+			theirs = theirs->next;
+			if (theirs)
+				from = theirs->first;
+		}
+		last = mine;
+		mine = mine->next;
+	}
+	//free what is left of ours
+	for (chunk *c = mine; c;)
+	{
+		chunk *temp = c->next;
+		free_chunk(c);
+		c = temp;
+	}
+	if (last)
+		last->next = 0;
+	else
+		d_head = 0;
+	d_tail = last;
+	d_size = other.d_size;
+	d_sum = other.d_sum;
+	return *this;
+}
+
+UnrolledDoublyLinkedList::UnrolledDoublyLinkedList(UnrolledDoublyLinkedList && other)
+: d_head(other.d_head), d_tail(other.d_tail), d_spare(0), d_size(other.d_size), d_sum(other.d_sum)
+{
+	other.d_head = other.d_tail = 0;
+	other.d_size = 0;
+	other.d_sum = 0;
+}
+
+UnrolledDoublyLinkedList & UnrolledDoublyLinkedList::operator=(UnrolledDoublyLinkedList && other)
+{
+	if (this == &other)
+		return *this;
+	clear();
+	d_head = other.d_head;
+	d_tail = other.d_tail;
+	d_size = other.d_size;
+	d_sum = other.d_sum;
+	other.d_head = other.d_tail = 0;
+	other.d_size = 0;
+	other.d_sum = 0;
+	return *this;
+}
+
+int UnrolledDoublyLinkedList::size() const
+{
+	return d_size;
+}
+
+// the inner loops run over plain arrays, so they vectorise (at -O3)
+int UnrolledDoublyLinkedList::min() const
+{
+	if (!d_head)
+		return 0;
+	int min = d_head->values[d_head->first];
+	for (const chunk *c = d_head; c; c = c->next)
+	{
+		const int *v = c->values + c->first;
+		for (int i = 0; i < c->count; ++i)
+			min = v[i] < min ? v[i] : min;
+	}
+	return min;
+}
+
+int UnrolledDoublyLinkedList::max() const
+{
+	if (!d_head)
+		return 0;
+	int max = d_head->values[d_head->first];
+	for (const chunk *c = d_head; c; c = c->next)
+	{
+		const int *v = c->values + c->first;
+		for (int i = 0; i < c->count; ++i)
+			max = v[i] > max ? v[i] : max;
+	}
+	return max;
+}
+
+int UnrolledDoublyLinkedList::sum() const
+{
+	return (int)d_sum;
+}
+
+double UnrolledDoublyLinkedList::mean() const
+{
+	return d_sum / (double)d_size;
+}
+
+void UnrolledDoublyLinkedList::put_rev(ostream& os) const
+{
+	const char *space = "";
+	for (const chunk *c = d_tail; c; c = c->prev)
+		for (int i = c->first + c->count - 1; i >= c->first; --i)
+		{
+			os << space << c->values[i];
+			space = " ";
+		}
+}
+
+ostream & operator<<(ostream & os, const UnrolledDoublyLinkedList & list)
+{
+	const char *space = "";
+	for (const chunk *c = list.d_head; c; c = c->next)
+		for (int i = c->first; i < c->first + c->count; ++i)
+		{
+			os << space << c->values[i];
+			space = " ";
+		}
+	return os;
+}
@@ -0,0 +1,54 @@
+// File: UnrolledDoublyLinkedList.h
+// Author(s): Jingyi Guo
+
+#include <iostream>
+#include <initializer_list>
+using namespace std;
+#ifndef _UNROLLED_DBL_LINK_LIST_
+#define _UNROLLED_DBL_LINK_LIST_
+
+// DoublyLinkedList's interface over an unrolled list: each node
+// (a Chunk) holds up to a few hundred bytes of values in an array,
+// so walking the list is a pointer per chunk instead of one per
+// value, and min() and max() are vectorisable loops over arrays.
+// Pushes and pops at either end are still O(1); a chunk is only
+// allocated or freed when one at an end fills up or empties, and
+// one emptied chunk is kept back for the next push.  size(), sum()
+// and mean() are O(1) as in DoublyLinkedList.
+class UnrolledDoublyLinkedList {
+public:
+    UnrolledDoublyLinkedList();        // default constructor
+    UnrolledDoublyLinkedList(int);     // construct a one-value list
+    UnrolledDoublyLinkedList(int,int); // construct a two-value list
+    UnrolledDoublyLinkedList(initializer_list<int>);
+    void put_rev(ostream &) const;     // display the list in reverse
+    struct Chunk;
+    friend ostream& operator <<(ostream&, const UnrolledDoublyLinkedList&);
+    ~UnrolledDoublyLinkedList();
+    void push_back(int);
+    void pop_back();
+    void push_front(int);
+    void pop_front();
+    int front() const;
+    int back() const;
+    UnrolledDoublyLinkedList(const UnrolledDoublyLinkedList&);
+    UnrolledDoublyLinkedList& operator=(const UnrolledDoublyLinkedList&);
+    UnrolledDoublyLinkedList(UnrolledDoublyLinkedList&&);
+    UnrolledDoublyLinkedList& operator=(UnrolledDoublyLinkedList&&);
+    int size() const;
+    int min() const;
+    int max() const;
+    int sum() const;
+    double mean() const;
+private:
+    Chunk *new_chunk();
+    void free_chunk(Chunk *);
+    void clear();
+
+    Chunk *d_head;             // 0 when empty
+    Chunk *d_tail;
+    Chunk *d_spare;            // an emptied chunk, kept for the next push
+    int d_size;
+    long long d_sum;
+};
+#endif
@@ -0,0 +1,139 @@
+// File: VolSurface.cpp
+// Author(s): Jingyi Guo
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <cmath>
+#include <cstring>
+#include <limits>
+using namespace std;
+#include "VolSurface.h"
+#include "Pa2Output.h"
+
+// a worker's arrays for the batch solver, reused slice after slice
+struct SolveScratch {
+	vector<double> forward, rate, t, vol;
+	vector<char> type;
+	vector<IVStatus> status;
+	vector<int> iterations;
+	IVTelemetry telemetry;
+};
+
+static void SolveSlice(const ContractSlice& src, double rate, VolSlice& slice, SolveScratch& scratch, bool timed)
+{
+	size_t n = src.size;
+	scratch.forward.assign(n, slice.forward);//a NaN forward or t <= 0 comes back as IV_BAD_INPUT
+	scratch.rate.assign(n, rate);
+	scratch.t.assign(n, slice.t);
+	scratch.type.assign(n, slice.type);
+	scratch.vol.resize(n);
+	scratch.status.resize(n);
+	scratch.iterations.resize(n);
+	IVBatchInput in = { src.settles, &scratch.forward[0], src.strikes, &scratch.rate[0], &scratch.t[0], &scratch.type[0] };
+	IVBatchOutput out = { &scratch.vol[0], &scratch.status[0], &scratch.iterations[0] };
+	ImpliedVolBatch(n, in, out, timed ? &scratch.telemetry : 0);
+	slice.points.resize(n);
+	for (size_t i = 0; i < n; ++i)
+	{
+		VolPoint& p = slice.points[i];
+		p.strike = src.strikes[i];
+		p.settle = src.settles[i];
+		p.vol = scratch.vol[i];
+		p.status = scratch.status[i];
+		p.iterations = scratch.iterations[i];
+	}
+}
+
+vector<VolSlice> BuildVolSurface(const ContractStore& store, const VolSurfaceConfig& config)
+{
+	const vector<ContractSlice>& src = store.slices();
+	vector<VolSlice> surface(src.size());
+	long today = DayNumber(config.valueDate);
+	for (size_t i = 0; i < src.size(); ++i)
+	{
+		VolSlice& slice = surface[i];
+		memcpy(slice.product, src[i].product, sizeof(slice.product));
+		slice.contractMonth = src[i].contractMonth;
+		slice.type = src[i].type;
+		slice.expiry = store.options_expiry(src[i].product, src[i].contractMonth);
+		if (!store.futures_settle(src[i].product, src[i].contractMonth, slice.forward))
+			slice.forward = numeric_limits<double>::quiet_NaN();
+		slice.t = slice.expiry ? (DayNumber(slice.expiry) - today) / 365.0 : 0;
+	}
+
+	// workers take the next unsolved slice until there are none left
+	atomic<size_t> next(0);
+	mutex merging;
+	auto work = [&]() {
+		SolveScratch scratch;
+		for (size_t i; (i = next++) < src.size(); )
+			if (src[i].size > 0)
+				SolveSlice(src[i], config.rate, surface[i], scratch, config.telemetry != 0);
+		if (config.telemetry)
+		{
+			lock_guard<mutex> guard(merging);
+			config.telemetry->merge(scratch.telemetry);
+		}
+	};
+	int threads = config.threads > 0 ? config.threads : (int)thread::hardware_concurrency();
+	if (threads > (int)src.size())
+		threads = (int)src.size();
+	vector<thread> pool;
+	for (int i = 1; i < threads; ++i)
+		pool.push_back(thread(work));
+	work();
+	for (size_t i = 0; i < pool.size(); ++i)
+		pool[i].join();
+	return surface;
+}
+
+int WriteVolSurfaceCsv(const vector<VolSlice>& surface, const string& prefix)
+{
+	static const char* statuses[] = { "ok", "below_intrinsic", "above_maximum", "bad_input", "no_convergence" };
+	int files = 0;
+	for (size_t first = 0, last; first < surface.size(); first = last)
+	{
+		//slices of a product are next to each other
+		for (last = first + 1; last < surface.size()
+			&& strncmp(surface[last].product, surface[first].product, 2) == 0; ++last)
+			;
+		OutBuffer out(prefix + string(surface[first].product, 2) + ".csv");
+		if (!out.ok())
+			return -1;
+		out.put("month,type,expiry,t,forward,strike,settle,vol,status,iterations\n");
+		for (size_t s = first; s < last; ++s)
+		{
+			const VolSlice& slice = surface[s];
+			for (size_t i = 0; i < slice.points.size(); ++i)
+			{
+				const VolPoint& p = slice.points[i];
+				out.put_int(slice.contractMonth);
+				out.put(',');
+				out.put(slice.type);
+				out.put(',');
+				out.put_int(slice.expiry);
+				out.put(',');
+				out.put_double(slice.t);
+				out.put(',');
+				out.put_double(slice.forward);
+				out.put(',');
+				out.put_double(p.strike);
+				out.put(',');
+				out.put_double(p.settle);
+				out.put(',');
+				out.put_double(p.vol);
+				out.put(',');
+				out.put(statuses[p.status]);
+				out.put(',');
+				out.put_int(p.iterations);
+				out.put('\n');
+			}
+		}
+		out.flush();
+		if (!out.ok())
+			return -1;
+		++files;
+	}
+	return files;
+}
@@ -0,0 +1,53 @@
+// File: VolSurface.h
+// Author(s): Jingyi Guo
+
+#include <string>
+#include <vector>
+using namespace std;
+#include "ContractStore.h"
+#include "ImpliedVol.h"
+#ifndef _VOL_SURFACE_
+#define _VOL_SURFACE_
+
+// One option on the surface
+struct VolPoint {
+    double strike;
+    double settle;
+    double vol;          // NaN unless status is IV_OK
+    IVStatus status;
+    int iterations;
+};
+
+// Implied vols of one (product, contract month, type), with the
+// forward and time to expiry they were solved at
+struct VolSlice {
+    char product[3];
+    int contractMonth;   // yyyymm
+    char type;           // 'C' or 'P'
+    int expiry;          // options expiry, yyyymmdd; 0 if the file had none
+    double forward;      // futures settlement of the same month; NaN if none
+    double t;            // years from the valuation date to expiry, ACT/365
+    vector<VolPoint> points;   // strikes ascending
+};
+
+struct VolSurfaceConfig {
+    int valueDate;       // yyyymmdd, the settlement date of the file
+    double rate;         // continuously compounded, for discounting
+    int threads;         // 0: one per hardware thread
+    IVTelemetry* telemetry;    // if set, every solve is timed and added to it
+};
+
+// Implied vols of every option in a built store.  Each slice takes
+// its forward from the futures settlement of its month and its
+// time to expiry from the options expiry record; a slice missing
+// either, or already expired, comes back with every point
+// IV_BAD_INPUT.  Slices are solved in parallel, one at a time per
+// worker, and come back in the store's order (product, month, type).
+// Each worker times its solves into its own telemetry, which is
+// merged into config.telemetry when it is done.
+vector<VolSlice> BuildVolSurface(const ContractStore& store, const VolSurfaceConfig& config);
+
+// One CSV per product, named prefix + product + ".csv", with a line
+// per option.  Returns the number of files written, -1 on failure.
+int WriteVolSurfaceCsv(const vector<VolSlice>& surface, const string& prefix);
+#endif
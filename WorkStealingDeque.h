@@ -0,0 +1,135 @@
+// File: WorkStealingDeque.h
+// Author(s): Jingyi Guo
+
+#include <cstddef>
+#include <vector>
+#include <atomic>
+#include <type_traits>
+using namespace std;
+#ifndef _WORK_STEALING_DEQUE_
+#define _WORK_STEALING_DEQUE_
+
+// A Chase-Lev work-stealing deque: the concurrent companion of
+// DoublyLinkedList for handing work between threads.  One thread,
+// the owner, pushes and pops at the back, as with a stack; any other
+// thread may pop from the front, taking the oldest item (a steal).
+// No locks: the owner's push_back and pop_back are a few plain loads
+// and stores, and only a steal, or a pop_back racing a steal for the
+// last item, needs a compare-and-swap, so thieves contend with each
+// other only, and only at the front.
+// Items live in a ring of slots that doubles when full.  A thief may
+// still be reading an outgrown ring, so those are kept until the
+// deque is destroyed (they add up to less than the live one).
+// The memory orders are those of Le, Pop, Cohen and Zappa Nardelli,
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (2013).
+// T has to be trivially copyable: a pointer to a batch, an index.
+template <class T>
+class WorkStealingDeque {
+    static_assert(is_trivially_copyable<T>::value, "items are copied bit by bit");
+public:
+    WorkStealingDeque(size_t capacity = 1024)  // rounded up to a power of 2
+    : d_top(0), d_bottom(0)
+    {
+        size_t n = 2;
+        while (n < capacity)
+            n *= 2;
+        d_ring.store(new Ring(n), memory_order_relaxed);
+    }
+
+    ~WorkStealingDeque()
+    {
+        delete d_ring.load(memory_order_relaxed);
+        for (size_t i = 0; i < d_retired.size(); ++i)
+            delete d_retired[i];
+    }
+
+    // owner only
+    void push_back(const T &item)
+    {
+        long long b = d_bottom.load(memory_order_relaxed);
+        long long t = d_top.load(memory_order_acquire);
+        Ring *ring = d_ring.load(memory_order_relaxed);
+        if (b - t > (long long)ring->mask)  // full
+            ring = grow(ring, t, b);
+        ring->put(b, item);
+        atomic_thread_fence(memory_order_release);
+        d_bottom.store(b + 1, memory_order_relaxed);
+    }
+
+    // owner only: the newest item; false if there is none
+    bool pop_back(T &item)
+    {
+        long long b = d_bottom.load(memory_order_relaxed) - 1;
+        Ring *ring = d_ring.load(memory_order_relaxed);
+        d_bottom.store(b, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        long long t = d_top.load(memory_order_relaxed);
+        if (t > b)  // empty
+        {
+            d_bottom.store(b + 1, memory_order_relaxed);
+            return false;
+        }
+        item = ring->get(b);
+        if (t < b)  // more than one left: no thief can reach this one
+            return true;
+        // the last one: whoever moves top first has it
+        bool won = d_top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+        d_bottom.store(b + 1, memory_order_relaxed);
+        return won;
+    }
+
+    // any thread: the oldest item; false if there is none, or if
+    // another thread took it first (try again, or try another deque)
+    bool pop_front(T &item)
+    {
+        long long t = d_top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        long long b = d_bottom.load(memory_order_acquire);
+        if (t >= b)
+            return false;
+        Ring *ring = d_ring.load(memory_order_acquire);
+        item = ring->get(t);
+        return d_top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+    }
+
+    // a snapshot, stale as soon as it is taken if other threads are busy
+    size_t size() const
+    {
+        long long b = d_bottom.load(memory_order_relaxed);
+        long long t = d_top.load(memory_order_relaxed);
+        return b > t ? (size_t)(b - t) : 0;
+    }
+    bool empty() const { return size() == 0; }
+private:
+    WorkStealingDeque(const WorkStealingDeque &);
+    WorkStealingDeque &operator=(const WorkStealingDeque &);
+
+    // slots are atomic so a thief may read one the owner is writing;
+    // relaxed, since top and bottom do the ordering
+    struct Ring {
+        size_t mask;           // capacity - 1
+        atomic<T> *slots;
+
+        Ring(size_t capacity) : mask(capacity - 1), slots(new atomic<T>[capacity]) { }
+        ~Ring() { delete[] slots; }
+        T get(long long i) const { return slots[i & mask].load(memory_order_relaxed); }
+        void put(long long i, const T &item) { slots[i & mask].store(item, memory_order_relaxed); }
+    };
+
+    Ring *grow(Ring *ring, long long t, long long b)
+    {
+        Ring *bigger = new Ring(2 * (ring->mask + 1));
+        for (long long i = t; i < b; ++i)
+            bigger->put(i, ring->get(i));
+        d_retired.push_back(ring);
+        d_ring.store(bigger, memory_order_release);
+        return bigger;
+    }
+
+    // top and bottom on cache lines of their own: thieves hammer top
+    alignas(64) atomic<long long> d_top;      // next to steal
+    alignas(64) atomic<long long> d_bottom;   // next to push; owner writes
+    alignas(64) atomic<Ring *> d_ring;
+    vector<Ring *> d_retired;                 // owner only
+};
+#endif
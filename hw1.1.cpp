@@ -3,130 +3,283 @@
 //  File:  hw1.1.cpp
 //  Authors:  Jingyi Guo
 //  Description:  Reads cme.20160826.c.pa2 as its input file, and produces CL_and_NG_expirations_and_settlements.txt as its output file
+//
+//  Usage:  hw1.1 [input [output]] [-f] [-t report|csv|bin] [-s]
+//          hw1.1 -m file... [-t report|csv|bin] [-s]
+//          hw1.1 -r dir from to [-t report|csv|bin] [-s]
+//      input   pa2 file (may be gzip'd), or - for stdin (default cme.20160826.c.pa2)
+//      output  output file, or - for stdout (default CL_and_NG_expirations_and_settlements.txt,
+//              .csv or .bin for the other formats)
+//      -f      follow a growing input file (like tail -f; not a .gz one); stop with Ctrl-C
+//      -t      output format: the fixed-width report (default), CSV, or binary records for hw3.3
+//      -s      also load the records into a ContractStore and print a summary of it to stderr
+//      -m      many files, each written to its own output named after it (cme.20160826.c.txt, ...)
+//      -r      like -m, for every dir/cme.yyyymmdd.c.pa2.gz from date from to date to that exists
+//  Reading stdin or following a file, each record is written out as soon as its line arrives.
+//  .gz inputs are decompressed in a second thread while the first one parses.
+//
+//  Build:  g++ -std=c++17 -O2 hw1.1.cpp SpanParser.cpp Pa2Output.cpp ContractStore.cpp GzReader.cpp -lz -pthread
 
 #include <iostream>
 #include <string>
 #include <fstream>
 #include <cstdlib>
+#include <vector>
+#include <chrono>
+#include <thread>
 using namespace std;
+#include "SpanParser.h"
+#include "Pa2Output.h"
+#include "ContractStore.h"
+#include "GzReader.h"
 
-bool TimeInRange(string line, int startnum)
+// one line per option slice: strikes, futures settlement and expiry
+void PutSummary(ostream& os, const ContractStore& store)
 {
-	string year_str = line.substr(startnum, 4);
-	int year = atoi(year_str.c_str());
-	string month_str = line.substr(startnum+4, 2);
-	int month = atof(month_str.c_str());
-	if ((year <= 2016 && month < 10) || (year > 2018))
-		return false;
-	else
-		return true;
+	const vector<ContractSlice>& slices = store.slices();
+	for (size_t i = 0; i < slices.size(); ++i)
+	{
+		const ContractSlice& s = slices[i];
+		os << s.product << "  " << s.contractMonth << (s.type == 'C' ? "  Call  " : "  Put   ")
+			<< s.size << " strikes " << s.strikes[0] << " - " << s.strikes[s.size - 1];
+		double fprice;
+		if (store.futures_settle(s.product, s.contractMonth, fprice))
+			os << "  futures " << fprice;
+		int expiry = store.options_expiry(s.product, s.contractMonth);
+		if (expiry)
+			os << "  expires " << expiry;
+		os << "\n";
+	}
+}
+
+Pa2RecordSink* MakeSink(const string& format, OutBuffer& out)
+{
+	if (format == "csv")
+		return new CsvSink(out);
+	if (format == "bin")
+		return new BinarySink(out);
+	return new ReportSink(out);
 }
 
+bool EndsWith(const string& s, const string& tail)
+{
+	return s.size() >= tail.size() && s.compare(s.size() - tail.size(), tail.size(), tail) == 0;
+}
 
-int main()
+// dir/cme.20160826.c.pa2.gz -> cme.20160826.c.txt
+string OutputName(string inName, const string& format)
 {
-	ifstream fin("cme.20160826.c.pa2");
-	ofstream fout("CL_and_NG_expirations_and_settlements.txt");
-	string line;
-	bool before8 = true;
-	fout << "Futures   Contract   Contract   Futures     Options   Options\n";
-	fout << "Code      Month      Type       Exp Date    Code      Exp Date\n";
-	fout << "-------   --------   --------   --------    -------   --------\n";
-	while (getline(fin, line))
+	size_t slash = inName.find_last_of("/\\");
+	if (slash != string::npos)
+		inName = inName.substr(slash + 1);
+	if (EndsWith(inName, ".gz"))
+		inName.resize(inName.size() - 3);
+	if (EndsWith(inName, ".pa2"))
+		inName.resize(inName.size() - 4);
+	return inName + "." + (format == "report" ? "txt" : format);
+}
+
+// the day after yyyymmdd, which must be a valid date
+int NextDay(int date)
+{
+	int year = date / 10000, month = date / 100 % 100, day = date % 100;
+	if (day < DaysInMonth(year, month))
+		return date + 1;
+	if (month < 12)
+		return year * 10000 + (month + 1) * 100 + 1;
+	return (year + 1) * 10000 + 101;
+}
+
+// every dir/cme.yyyymmdd.c.pa2.gz in [from, to] that exists
+vector<string> ArchiveRange(const string& dir, int from, int to)
+{
+	vector<string> files;
+	for (int date = from; date <= to; date = NextDay(date))
 	{
-		if (line[0] == 'B')//Type B records
-		{
-			if ((line[99] == 'C' && line[100] == 'L' && line[101] == ' ') || (line[99] == 'N' && line[100] == 'G' && line[101] == ' '))//CL or NG
-			{
-				if (line[15] == 'F' && line[16] == 'U' && line[17] == 'T' && TimeInRange(line, 18))//Futures
-				{
-					fout << line[99] << line[100] << "        ";//futures code
-					//futures contract date
-					fout << line[18] << line[19] << line[20] << line[21] << "-" << line[22] << line[23] << "    ";
-					fout << "Fut        ";//contract type
-					//expiration date
-					fout << line[91] << line[92] << line[93] << line[94] << "-" << line[95] << line[96] << "-" << line[97] << line[98] << "\n";
-				} 
-				if (line[15] == 'O' && line[16] == 'O' && line[17] == 'F' && ((line[5] == 'L' && line[6] == 'O') || (line[5] == 'O' && line[6] == 'N')) && TimeInRange(line,27))// LO or ON Options
-				{
-					fout << line[99] << line[100] << "        ";//futures code
-					//options contract date
-					fout << line[27] << line[28] << line[29] << line[30] << "-" << line[31] << line[32] << "    ";
-					fout << "Opt                    ";//contract type
-					fout << line[5] << line[6] << "        ";//options code
-					//expiration date
-					fout << line[91] << line[92] << line[93] << line[94] << "-" << line[95] << line[96] << "-" << line[97] << line[98] << "\n";
-				}
+		string name = dir + "/cme." + to_string(date) + ".c.pa2.gz";
+		if (ifstream(name.c_str()))
+			files.push_back(name);
+	}
+	return files;
+}
 
-			}
+// Parse the inputs through a GzChunkReader: decompression runs one
+// chunk ahead of parsing.  Each input goes to its own output, and
+// only one input's output is open at a time.
+int ParseArchives(const vector<string>& inNames, const vector<string>& outNames,
+	const string& format, Pa2RecordSink* store)
+{
+	GzChunkReader reader(inNames);
+	GzChunkReader::Chunk chunk;
+	OutBuffer* out = 0;
+	Pa2RecordSink* sink = 0;
+	TeeSink* tee = 0;
+	Pa2StreamParser* parser = 0;
+	int status = 0;
+	while (reader.next(chunk))
+	{
+		if (!parser)
+		{
+			out = new OutBuffer(outNames[chunk.file]);
+			sink = MakeSink(format, *out);
+			tee = store ? new TeeSink(*sink, *store) : 0;
+			parser = new Pa2StreamParser(tee ? (Pa2RecordSink&)*tee : *sink);
 		}
-		if (line[0] == '8' && line[1] == '1' && line[2]== 'N' && line[3]=='Y' && line[4]=='M')//Type 8 Records
+		parser->feed(chunk.data, chunk.size);
+		if (!chunk.endOfFile)
+			continue;
+		parser->finish();
+		out->flush();
+		if (chunk.failed || !out->ok())
+		{
+			cerr << "cannot read " << inNames[chunk.file] << " or write " << outNames[chunk.file] << "\n";
+			status = 1;
+		}
+		delete parser;
+		delete tee;
+		delete sink;
+		delete out;
+		parser = 0;
+	}
+	return status;
+}
+
+int main(int argc, char* argv[])
+{
+	string inName = "cme.20160826.c.pa2";
+	string outName = "";
+	string format = "report";
+	bool follow = false;
+	bool summary = false;
+	bool many = false;
+	vector<string> names;
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		if (arg == "-f")
+			follow = true;
+		else if (arg == "-s")
+			summary = true;
+		else if (arg == "-m")
+			many = true;
+		else if (arg == "-r" && i + 3 < argc)
 		{
-			if (before8)
+			int from = atoi(argv[i + 2]), to = atoi(argv[i + 3]);
+			if (!ValidDate(from) || !ValidDate(to))
 			{
-				fout << "\n";
-				fout << "Futures   Contract   Contract   Strike   Settlement\n";
-				fout << "Code      Month      Type       Price    Price\n";
-				fout << "-------   --------   --------   ------   ----------\n";
-				before8 = false;
+				cerr << "-r needs two dates as yyyymmdd\n";
+				return 1;
 			}
-			if ((line[15] == 'C' && line[16] == 'L' && line[17] == ' ') || (line[15] == 'N' && line[16] == 'G'&& line[17] == ' '))//CL or NG
-			{
-				if (line[25] == 'F' && line[26] == 'U' && line[27] == 'T' && TimeInRange(line,29))//Futures
-				{
-					fout << line[15] << line[16] << "        ";//futures code[
-					//futures contract date
-					fout << line[29] << line[30] << line[31] << line[32] << "-" << line[33] << line[34] << "    ";
-					fout << "Fut                 ";//contract type
-					if (line[15] == 'C' && line[16] == 'L')
-					{
-						fout << line[118] << line[119] << "." << line[120] << line[121] << "\n";//settlement price
-					}
-					if (line[15] == 'N' && line[16] == 'G')
-					{
-						fout << line[116] << "." << line[117] << line[118] << line[119] << "\n";//settlement price
-					}
-					
-				}
-				if (line[25] == 'O' && line[26] == 'O' && line[27] == 'F' && TimeInRange(line,38) && ((line[5]=='L' && line[6]=='O')|| (line[5] == 'O' && line[6] == 'N')))//American Options
-				{
-					fout << line[15] << line[16] << "        ";//futures code
-					//options contract date
-					fout << line[38] << line[39] << line[40] << line[41] << "-" << line[42] << line[43] << "    ";
-					if (line[28] == 'C')
-					{
-						fout << "Call       ";
-					}
-					if (line[28] == 'P')
-					{
-						fout << "Put        ";
-					}
-					if (line[15] == 'N' && line[16] == 'G')
-					{
-						fout << line[50] << "." << line[51] << line[52] << line[53] << "     ";//strike price
-						fout << line[118] << "." << line[119] << line[120] << line[121] << "\n";//settlement price
-					}
-					if (line[15] == 'C' && line[16] == 'L')
-					{
-						fout << line[51] << "." << line[52] << line[53] << "     ";//strike price
-						if (line[28] == 'P')
-						{
-							fout << " " << line[119] << "." << line[120] << line[121] << "\n";//settlement price
-						}
-						if (line[28] == 'C')
-						{
-							if (line[118] != '0')
-							{
-								fout << line[118] << line[119] << "." << line[120] << line[121] << "\n";//settlement price
-							}
-							else 
-							    fout << " " << line[119] << "." << line[120] << line[121] << "\n";//settlement price
-						}
+			vector<string> range = ArchiveRange(argv[i + 1], from, to);
+			names.insert(names.end(), range.begin(), range.end());
+			many = true;
+			i += 3;
+		}
+		else if (arg == "-t" && i + 1 < argc)
+			format = argv[++i];
+		else
+			names.push_back(arg);
+	}
+	if ((format != "report" && format != "csv" && format != "bin") || (!many && names.size() > 2)
+		|| (many && follow))
+	{
+		cerr << "usage: " << argv[0] << " [input [output]] [-f] [-t report|csv|bin] [-s]\n";
+		cerr << "       " << argv[0] << " -m file... [-t report|csv|bin] [-s]\n";
+		cerr << "       " << argv[0] << " -r dir yyyymmdd yyyymmdd [-t report|csv|bin] [-s]\n";
+		return 1;
+	}
+	if (!many && names.size() > 0)
+		inName = names[0];
+	if (!many && names.size() > 1)
+		outName = names[1];
+	if (follow && EndsWith(inName, ".gz"))
+	{
+		cerr << "cannot follow a .gz file: -f reads plain pa2 only\n";
+		return 1;
+	}
+	if (outName.empty())
+		outName = "CL_and_NG_expirations_and_settlements." + string(format == "report" ? "txt" : format);
 
-					}
-				}
-			}
+	ContractStore store;
+	if (many || (EndsWith(inName, ".gz") && !follow))
+	{
+		vector<string> outNames;
+		if (!many)
+			names.assign(1, inName);
+		for (size_t i = 0; i < names.size(); ++i)
+			outNames.push_back(many ? OutputName(names[i], format) : outName);
+		int status = ParseArchives(names, outNames, format, summary ? &store : 0);
+		if (summary)
+		{
+			store.build();
+			PutSummary(cerr, store);
+		}
+		return status;
+	}
+
+	ios::sync_with_stdio(false);
+	ifstream fin;
+	istream* in = &cin;
+	if (inName != "-")
+	{
+		fin.open(inName.c_str(), ios::binary);
+		if (!fin)
+		{
+			cerr << "cannot open " << inName << "\n";
+			return 1;
+		}
+		in = &fin;
+	}
+	OutBuffer out(outName);
+	if (!out.ok())
+	{
+		cerr << "cannot write " << outName << "\n";
+		return 1;
+	}
+	Pa2RecordSink* sink = MakeSink(format, out);
+	TeeSink tee(*sink, store);
+	Pa2StreamParser parser(summary ? (Pa2RecordSink&)tee : *sink);
+	if (!follow && in == &fin)
+	{
+		// whole file at once: read in big chunks
+		vector<char> buf(1 << 20);
+		while (fin.read(&buf[0], buf.size()) || fin.gcount() > 0)
+			parser.feed(&buf[0], fin.gcount());
+	}
+	else
+	{
+		// streaming: hand over each line as soon as it arrives
+		string line;
+		while (!in->bad())
+		{
+			getline(*in, line);
+			bool complete = !in->eof();
+			if (complete)
+				line += '\n';
+			long before = parser.records();
+			parser.feed(line.data(), line.size());//a partial last line is kept by the parser
+			if (parser.records() != before)
+				out.flush();
+			if (complete)
+				continue;
+			if (!follow)
+				break;
+			in->clear();//nothing more for now: wait for the file to grow
+			this_thread::sleep_for(chrono::milliseconds(200));
 		}
 	}
+	parser.finish();
+	delete sink;
+	out.flush();
+	if (!out.ok())
+	{
+		cerr << "cannot write " << outName << "\n";
+		return 1;
+	}
+	if (summary)
+	{
+		store.build();
+		PutSummary(cerr, store);
+	}
 	return 0;
 }
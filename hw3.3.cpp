@@ -8,19 +8,12 @@
 #include <string>
 #include <cstdlib>
 using namespace std;
-
-// define the NormCDF function here
-double NormCDF(double x)//(a)
-{
-	return (1 / 2.0 + 1 / 2.0 * erf(x / sqrt(2.0)));
-}
-
-double BSMEuroCallPrice(double s0, double k, double r, double t, double sigma)//(a)
-{
-	double d1 = (log(s0 / k) + (r + pow(sigma, 2.0) / 2.0)*t) / (sigma*sqrt(t));
-	double d2 = d1 - sigma*sqrt(t);
-	return (s0*NormCDF(d1) - exp(-r*t)*k*NormCDF(d2));
-}
+#include "Pa2Output.h"
+#include "ContractStore.h"
+#include "OptionMath.h"
+#include "ImpliedVol.h"
+#include "VolSurface.h"
+#include "SviSmile.h"
 
 void CallDisplay(double s0, double k, double r, double t, double sigma)//(b)
 {
@@ -30,49 +23,80 @@ void CallDisplay(double s0, double k, double r, double t, double sigma)//(b)
 		<< BSMEuroCallPrice(s0, k, r, t, sigma) << '\n';
 }
 
-double Black76CallPrice(double f, double k, double r, double t, double sigma)//(a)
+// fitted SVI parameters, one line per product and month
+void PutSviParams(ostream& out, const vector<SviSlice>& slices)
 {
-	double d1 = (log(f / k) + (pow(sigma, 2.0) / 2.0)*t) / (sigma*sqrt(t));
-	double d2 = d1 - sigma*sqrt(t);
-	return (exp(-r*t)*(f*NormCDF(d1) - k*NormCDF(d2)));
-}
-
-double ImpliedVol(double C, double f, double k, double r, double t)//(b)
-{
-	double a = 0.0;
-	double b = 3.0;
-	double c = (a+b)/2.0;
-	while (true)
+	out << "product,month,t,forward,a,b,rho,m,sigma,rmse,points\n" << setprecision(10);
+	for (size_t i = 0; i < slices.size(); ++i)
 	{
-		c = (a + b) / 2.0;
-		double fa = C - Black76CallPrice(f, k, r, t, a);
-		double fb = C - Black76CallPrice(f, k, r, t, b);
-		double fc = C - Black76CallPrice(f, k, r, t, c);
-		if (fabs(fc) <= 0.0001)
-			return c;
-		if (fa*fc > 0)
-			a = c;
-		if (fa*fc < 0)
-			b = c;
+		const SviSlice& s = slices[i];
+		out << s.product << ',' << s.contractMonth << ',' << s.t << ',' << s.forward << ','
+			<< s.params.a << ',' << s.params.b << ',' << s.params.rho << ',' << s.params.m << ','
+			<< s.params.sigma << ',' << s.rmse << ',' << s.points << '\n';
 	}
 }
 
-int main()
+// Usage:  hw3.3 [input] [-a yyyymmdd [-t]]
+//   input is hw1.1's report (default CL_and_NG_expirations_and_settlements.txt),
+//   or a .bin file from "hw1.1 -t bin", which is read without any text parsing
+//   -a solves every product, month, call and put, as of the settlement date
+//   given, into vol_surface_<product>.csv, and fits an SVI smile to each
+//   month, into svi_params.csv
+//   -t also times every solve of -a and prints the latency and
+//   iteration histograms to stderr
+// Build:  g++ -std=c++17 -O2 -pthread hw3.3.cpp SviSmile.cpp VolSurface.cpp ImpliedVol.cpp ContractStore.cpp Pa2Output.cpp SpanParser.cpp
+int main(int argc, char* argv[])
 {
-	ifstream fin("CL_and_NG_expirations_and_settlements.txt");
-	ofstream fout("strike_vs_impvol.csv");
-	string line;
-	fout << "Strike, ImpVol\n";
-	double fprice = 48.33;
-	while (getline(fin, line))//(c)
+	string inName = "CL_and_NG_expirations_and_settlements.txt";
+	int valueDate = 0;
+	bool timed = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		if (arg == "-a" && i + 1 < argc)
+			valueDate = atoi(argv[++i]);
+		else if (arg == "-t")
+			timed = true;
+		else if (arg[0] != '-')
+			inName = arg;
+		else
+		{
+			cerr << "usage: " << argv[0] << " [input] [-a yyyymmdd [-t]]\n";
+			return 1;
+		}
+	}
+	ContractStore store;
+	bool binary = inName.size() > 4 && inName.compare(inName.size() - 4, 4, ".bin") == 0;
+	if ((binary ? ReadPa2Binary(inName, store) : ReadPa2Report(inName, store)) < 0)
 	{
-		if (line.substr(0, 25) == "CL        2016-11    Call")
+		cerr << "cannot read records from " << inName << "\n";
+		return 1;
+	}
+	store.build();
+	if (valueDate)
+	{
+		IVTelemetry telemetry;
+		VolSurfaceConfig config = { valueDate, 0.02, 0, timed ? &telemetry : 0 };
+		vector<VolSlice> surface = BuildVolSurface(store, config);
+		if (timed)
+			telemetry.put(cerr);
+		if (WriteVolSurfaceCsv(surface, "vol_surface_") < 0)
 		{
-			double strike = atof(line.substr(32, 6).c_str());
-			double cprice = atof(line.substr(42, 6).c_str());
-			fout << strike << ", "  << ImpliedVol(cprice, fprice, strike, 0.02, 56.0 / 365) << "\n";
+			cerr << "cannot write vol_surface_*.csv\n";
+			return 1;
 		}
+		SviCalibrator svi;
+		svi.calibrate(surface);
+		ofstream sviOut("svi_params.csv");
+		PutSviParams(sviOut, svi.slices());
+		return 0;
 	}
+	ofstream fout("strike_vs_impvol.csv");
+	fout << "Strike, ImpVol\n";
+	double fprice = 48.33;
+	const ContractSlice* calls = store.find("CL", 201611, 'C');//(c)
+	for (size_t i = 0; calls && i < calls->size; ++i)
+		fout << calls->strikes[i] << ", " << ImpliedVol(calls->settles[i], fprice, calls->strikes[i], 0.02, 56.0 / 365) << "\n";
 	/*(d)
 	The assumption that volatility is constant in Black-Scholes-Mertion model is improper according to my plot,
 	because in my plot, the graph of implied volatility against strike is a skewed "smile" curve rather than a flat line.